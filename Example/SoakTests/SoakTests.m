@@ -0,0 +1,199 @@
+//
+//  SoakTests.m
+//  youtube-ios-player-helper
+//
+//  Long-running soak tests and million-entry benchmarks, kept out of the unit test target so that
+//  the default scheme stays fast. Run them with the youtube-ios-player-helper-SoakTests scheme.
+//
+
+@import XCTest;
+@import YTPlayerView;
+#import <mach/mach.h>
+
+static NSUInteger const ResumeStoreBenchmarkCount = 1000000;
+static NSUInteger const SoakCycleCount = 2000;
+
+static NSString * const ResumeStoreBenchmarkFixtureName = @"YTPlayerResumeStoreBenchmark";
+static NSString * const ResumeStoreUpdateBenchmarkName = @"YTPlayerResumeStoreUpdateBenchmark";
+
+// Stub player page for the soak test. It loads no external script and posts what the iframe player would
+// through the real script message bridge, so that every event comes from here and not from YouTube.
+static NSString * const SoakEmbedHTMLTemplate =
+    @"<!DOCTYPE html><html><body><script>"
+    @"var playerParams = %@;"
+    @"var handler = window.webkit.messageHandlers.callback;"
+    @"handler.postMessage('ytplayer://onReady?data=null');"
+    @"handler.postMessage('ytplayer://onStateChange?data=1');"
+    @"handler.postMessage('ytplayer://onPlayTime?data=1.5');"
+    @"handler.postMessage('ytplayer://onStateChange?data=2');"
+    @"</script></body></html>";
+
+// Notifies the soak test once the fake player has been paused.
+@interface SoakPlayerDelegate : NSObject <YTPlayerViewDelegate>
+
+@property (nonatomic, strong) XCTestExpectation *pausedExpectation;
+
+@end
+
+@implementation SoakPlayerDelegate
+
+- (void)playerView:(YTPlayerView *)playerView didChangeToState:(YTPlayerState)state
+{
+    if (state == YTPlayerStatePaused) {
+        [self.pausedExpectation fulfill];
+        self.pausedExpectation = nil;
+    }
+}
+
+@end
+
+// The million-position store shared by the resume store benchmarks. Built on first use and removed
+// once the whole class has run, since building it takes far longer than any single benchmark.
+static NSString *ResumeStoreBenchmarkFixturePath = nil;
+
+@interface SoakTests : XCTestCase
+
+@end
+
+@implementation SoakTests
+
++ (void)tearDown
+{
+    if (ResumeStoreBenchmarkFixturePath) {
+        [[NSFileManager defaultManager] removeItemAtPath:ResumeStoreBenchmarkFixturePath error:nil];
+        ResumeStoreBenchmarkFixturePath = nil;
+    }
+    [super tearDown];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:[NSTemporaryDirectory() stringByAppendingPathComponent:ResumeStoreUpdateBenchmarkName] error:nil];
+    [super tearDown];
+}
+
+#pragma mark - YTPlayerResumeStore
+
+- (NSArray<NSString *> *)videoIdsWithCount:(NSUInteger)count
+{
+    NSMutableArray *videoIds = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [videoIds addObject:[NSString stringWithFormat:@"video%06lu", (unsigned long)i]];
+    }
+    return videoIds;
+}
+
+- (NSString *)temporaryResumeStorePath:(NSString *)name
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    return path;
+}
+
+- (NSString *)resumeStoreBenchmarkFixturePath
+{
+    if (!ResumeStoreBenchmarkFixturePath) {
+        NSString *path = [self temporaryResumeStorePath:ResumeStoreBenchmarkFixtureName];
+        YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+        for (NSUInteger i = 0; i < ResumeStoreBenchmarkCount; i++) {
+            [store setPosition:(float)(i % 3600) forVideoId:[NSString stringWithFormat:@"video%06lu", (unsigned long)i]];
+        }
+        [store compact:nil];
+        ResumeStoreBenchmarkFixturePath = path;
+    }
+    return ResumeStoreBenchmarkFixturePath;
+}
+
+- (void)testResumeStoreColdOpenPerformance
+{
+    NSString *path = [self resumeStoreBenchmarkFixturePath];
+    [self measureBlock:^{
+        YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+        XCTAssertEqual([store positionForVideoId:@"video123456"], (float)(123456 % 3600));
+    }];
+}
+
+- (void)testResumeStoreLookupPerformance
+{
+    YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:[self resumeStoreBenchmarkFixturePath] error:nil];
+    NSArray *videoIds = [self videoIdsWithCount:ResumeStoreBenchmarkCount];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < videoIds.count; i++) {
+            if ([store positionForVideoId:videoIds[i]] != (float)(i % 3600)) {
+                XCTFail(@"Wrong position for %@", videoIds[i]);
+                break;
+            }
+        }
+    }];
+}
+
+- (void)testResumeStoreUpdatePerformance
+{
+    NSString *path = [self temporaryResumeStorePath:ResumeStoreUpdateBenchmarkName];
+    [[NSFileManager defaultManager] copyItemAtPath:[self resumeStoreBenchmarkFixturePath] toPath:path error:nil];
+    YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+    NSArray *videoIds = [self videoIdsWithCount:ResumeStoreBenchmarkCount];
+    __block float seconds = 0;
+    [self measureBlock:^{
+        seconds += 1;
+        for (NSUInteger i = 0; i < videoIds.count; i += 10) {
+            [store setPosition:seconds forVideoId:videoIds[i]];
+        }
+    }];
+    XCTAssertEqual([store positionForVideoId:videoIds[0]], seconds);
+}
+
+#pragma mark - YTPlayerView
+
+- (uint64_t)memoryFootprint
+{
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.phys_footprint;
+}
+
+- (void)drainRunLoopUntilEmpty:(NSHashTable *)objects
+{
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    while (objects.allObjects.count > 0 && deadline.timeIntervalSinceNow > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    }
+}
+
+- (void)testPlayerCreateLoadPlayDestroySoak
+{
+    NSHashTable *players = [NSHashTable weakObjectsHashTable];
+    NSHashTable *webViews = [NSHashTable weakObjectsHashTable];
+    uint64_t baselineFootprint = 0;
+
+    for (NSUInteger i = 0; i < SoakCycleCount; i++) {
+        @autoreleasepool {
+            SoakPlayerDelegate *delegate = [[SoakPlayerDelegate alloc] init];
+            delegate.pausedExpectation = [self expectationWithDescription:@"paused"];
+            YTPlayerView *player = [[YTPlayerView alloc] initWithFrame:CGRectMake(0, 0, 320, 180)];
+            player.delegate = delegate;
+            player.embedHTMLTemplate = SoakEmbedHTMLTemplate;
+            XCTAssertTrue([player loadPlayerWithVideoId:@"M7lc1UVf-VE"]);
+            [players addObject:player];
+            [webViews addObject:player.webView];
+            [self waitForExpectationsWithTimeout:10.0 handler:nil];
+        }
+
+        if ((i + 1) % 500 == 0) {
+            [self drainRunLoopUntilEmpty:webViews];
+            XCTAssertEqual(players.allObjects.count, (NSUInteger)0, @"YTPlayerView leaked after %@ cycles", @(i + 1));
+            XCTAssertEqual(webViews.allObjects.count, (NSUInteger)0, @"WKWebView leaked after %@ cycles", @(i + 1));
+            if (baselineFootprint == 0) {
+                baselineFootprint = [self memoryFootprint];
+            }
+        }
+    }
+
+    uint64_t footprint = [self memoryFootprint];
+    XCTAssertLessThan(footprint, baselineFootprint + 32 * 1024 * 1024, @"Memory grew from %@ to %@ bytes", @(baselineFootprint), @(footprint));
+}
+
+@end
@@ -7,6 +7,38 @@
 //
 
 @import XCTest;
+@import YTPlayerView;
+
+// Stub player page that counts the windows of a YTPlayerQueue passed to it.
+static NSString * const QueueEmbedHTMLTemplate =
+    @"<!DOCTYPE html><html><body><script>"
+    @"var playerParams = %@;"
+    @"var playlistLoadCount = 0;"
+    @"var player = {"
+    @"  loadPlaylist: function() { playlistLoadCount++; },"
+    @"  cuePlaylist: function() { playlistLoadCount++; },"
+    @"  loadVideoById: function() {},"
+    @"  setLoop: function() {}"
+    @"};"
+    @"window.webkit.messageHandlers.callback.postMessage('ytplayer://onReady?data=null');"
+    @"</script></body></html>";
+
+// Notifies a test once the player has become ready.
+@interface ReadyPlayerDelegate : NSObject <YTPlayerViewDelegate>
+
+@property (nonatomic, strong, nullable) XCTestExpectation *readyExpectation;
+
+@end
+
+@implementation ReadyPlayerDelegate
+
+- (void)playerViewDidBecomeReady:(YTPlayerView *)playerView
+{
+    [self.readyExpectation fulfill];
+    self.readyExpectation = nil;
+}
+
+@end
 
 @interface Tests : XCTestCase
 
@@ -31,5 +63,423 @@
     XCTFail(@"No implementation for \"%s\"", __PRETTY_FUNCTION__);
 }
 
-@end
+#pragma mark - YTPlayerQueue
+
+- (NSArray<NSString *> *)videoIdsWithCount:(NSUInteger)count
+{
+    NSMutableArray *videoIds = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [videoIds addObject:[NSString stringWithFormat:@"video%06lu", (unsigned long)i]];
+    }
+    return videoIds;
+}
+
+- (void)testQueueTraversesLargeQueueInBothDirections
+{
+    YTPlayerQueue *queue = [[YTPlayerQueue alloc] initWithVideoIds:[self videoIdsWithCount:100000]];
+    NSUInteger steps = 0;
+    while ([queue advance]) {
+        steps++;
+    }
+    XCTAssertEqual(steps, (NSUInteger)99999);
+    XCTAssertEqualObjects(queue.currentVideoId, @"video099999");
+    XCTAssertEqual([queue nextPosition], (NSUInteger)NSNotFound);
+    
+    queue.loopMode = YTPlayerQueueLoopModeAll;
+    XCTAssertTrue([queue advance]);
+    XCTAssertEqual(queue.currentPosition, (NSUInteger)0);
+    XCTAssertTrue([queue retreat]);
+    XCTAssertEqual(queue.currentPosition, (NSUInteger)99999);
+}
+
+- (void)testQueueShuffleIsReproducibleFromSeed
+{
+    NSArray *videoIds = [self videoIdsWithCount:100000];
+    YTPlayerQueue *queue1 = [[YTPlayerQueue alloc] initWithVideoIds:videoIds];
+    YTPlayerQueue *queue2 = [[YTPlayerQueue alloc] initWithVideoIds:videoIds];
+    queue1.currentPosition = 42;
+    [queue1 shuffleWithSeed:20160317];
+    [queue2 shuffleWithSeed:20160317];
+    XCTAssertEqualObjects(queue1.currentVideoId, @"video000042");
+    
+    NSMutableIndexSet *visited = [NSMutableIndexSet indexSet];
+    for (NSUInteger position = 0; position < videoIds.count; position++) {
+        NSUInteger index = [queue1 videoIndexAtPosition:position];
+        XCTAssertEqual(index, [queue2 videoIndexAtPosition:position]);
+        [visited addIndex:index];
+    }
+    XCTAssertEqual(visited.count, videoIds.count);
+    
+    [queue1 unshuffle];
+    XCTAssertEqual(queue1.currentPosition, (NSUInteger)42);
+}
+
+- (void)testQueuePlayOrderChangesAreObservable
+{
+    YTPlayerQueue *queue = [[YTPlayerQueue alloc] initWithVideoIds:[self videoIdsWithCount:10]];
+    [self keyValueObservingExpectationForObject:queue keyPath:@"shuffled" expectedValue:@YES];
+    [self keyValueObservingExpectationForObject:queue keyPath:@"loopMode" expectedValue:@(YTPlayerQueueLoopModeAll)];
+    [queue shuffleWithSeed:20160317];
+    queue.loopMode = YTPlayerQueueLoopModeAll;
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+}
+
+- (void)testQueueWindowMapsBackToGlobalPositions
+{
+    YTPlayerQueue *queue = [[YTPlayerQueue alloc] initWithVideoIds:[self videoIdsWithCount:100000]];
+    queue.windowSize = 20;
+    
+    NSRange window = [queue windowAroundPosition:0];
+    XCTAssertEqual(window.location, (NSUInteger)0);
+    XCTAssertEqual(window.length, (NSUInteger)20);
+    XCTAssertFalse([queue window:window needsSlidingForPosition:18]);
+    XCTAssertTrue([queue window:window needsSlidingForPosition:19]);
+    
+    window = [queue windowAroundPosition:50000];
+    NSUInteger index = [queue indexForPosition:50000 inWindow:window];
+    XCTAssertEqual([queue positionForIndex:index inWindow:window], (NSUInteger)50000);
+    XCTAssertEqualObjects([queue videoIdsInWindow:window][index], @"video050000");
+    XCTAssertEqual([queue positionForIndex:20 inWindow:window], (NSUInteger)NSNotFound);
+    
+    queue.loopMode = YTPlayerQueueLoopModeAll;
+    window = [queue windowAroundPosition:0];
+    XCTAssertEqual([queue positionForIndex:0 inWindow:window], (NSUInteger)99995);
+    XCTAssertEqualObjects([queue videoIdsInWindow:window][5], @"video000000");
+    
+    queue.loopMode = YTPlayerQueueLoopModeOne;
+    window = [queue windowAroundPosition:777];
+    XCTAssertEqual(window.length, (NSUInteger)1);
+    XCTAssertFalse([queue window:window needsSlidingForPosition:777]);
+}
+
+- (void)testQueueSmallWindowDoesNotSlideRightAfterLoading
+{
+    YTPlayerQueue *queue = [[YTPlayerQueue alloc] initWithVideoIds:[self videoIdsWithCount:10]];
+    for (NSUInteger windowSize = 1; windowSize <= 3; windowSize++) {
+        queue.windowSize = windowSize;
+        for (NSNumber *loopMode in @[@(YTPlayerQueueLoopModeNone), @(YTPlayerQueueLoopModeAll)]) {
+            queue.loopMode = loopMode.integerValue;
+            for (NSUInteger position = 0; position < queue.count; position++) {
+                NSRange window = [queue windowAroundPosition:position];
+                XCTAssertGreaterThanOrEqual(window.length, (NSUInteger)3);
+                XCTAssertFalse([queue window:window needsSlidingForPosition:position],
+                               @"windowSize %lu, loopMode %@, position %lu", (unsigned long)windowSize, loopMode, (unsigned long)position);
+            }
+        }
+    }
+}
+
+- (void)testQueueIsDetachedWhenAnotherVideoIsLoaded
+{
+    ReadyPlayerDelegate *delegate = [[ReadyPlayerDelegate alloc] init];
+    delegate.readyExpectation = [self expectationWithDescription:@"ready"];
+    YTPlayerView *player = [[YTPlayerView alloc] initWithFrame:CGRectMake(0, 0, 320, 180)];
+    player.delegate = delegate;
+    player.embedHTMLTemplate = QueueEmbedHTMLTemplate;
+    XCTAssertTrue([player loadPlayerWithVideoId:@"M7lc1UVf-VE"]);
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    
+    YTPlayerQueue *queue = [[YTPlayerQueue alloc] initWithVideoIds:[self videoIdsWithCount:10]];
+    XCTestExpectation *queueLoaded = [self expectationWithDescription:@"queue loaded"];
+    [player loadVideoQueue:queue startSeconds:0 suggestedQuality:YTPlaybackQualityDefault callback:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [queueLoaded fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    XCTAssertEqual(player.videoQueue, queue);
+    
+    XCTestExpectation *videoLoaded = [self expectationWithDescription:@"video loaded"];
+    [player loadVideoById:@"M7lc1UVf-VE" startSeconds:0 suggestedQuality:YTPlaybackQualityDefault callback:^(NSError * _Nullable error) {
+        [videoLoaded fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    XCTAssertNil(player.videoQueue);
+    
+    // The app keeps using its own queue, which must not take over the player again.
+    [queue shuffleWithSeed:20160317];
+    queue.loopMode = YTPlayerQueueLoopModeAll;
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+    
+    XCTestExpectation *counted = [self expectationWithDescription:@"counted"];
+    [player.webView evaluateJavaScript:@"playlistLoadCount;" completionHandler:^(id _Nullable result, NSError * _Nullable error) {
+        XCTAssertEqualObjects(result, @1);
+        [counted fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+}
+
+#pragma mark - YTPlayerScrubber
 
+- (void)testScrubberCoalescesSeeksWithSlowTransport
+{
+    __block NSUInteger evaluations = 0;
+    __block NSUInteger inFlight = 0;
+    __block NSUInteger maxInFlight = 0;
+    __block float lastSeconds = -1;
+    __block BOOL lastAllowSeekAhead = NO;
+    // Fake transport: every seek takes 50ms to round-trip.
+    YTPlayerScrubber *scrubber = [[YTPlayerScrubber alloc] initWithSeekHandler:^(float seconds, BOOL allowSeekAhead, YTPlayerScrubberSeekCompletion completion) {
+        evaluations++;
+        inFlight++;
+        maxInFlight = MAX(maxInFlight, inFlight);
+        lastSeconds = seconds;
+        lastAllowSeekAhead = allowSeekAhead;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.05 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            inFlight--;
+            completion(nil);
+        });
+    }];
+    
+    // Drag for one second at 120 touch events per second.
+    [scrubber begin];
+    NSUInteger updates = 120;
+    for (NSUInteger i = 1; i <= updates; i++) {
+        [scrubber updateToSeconds:i * 0.5f];
+        XCTAssertEqual(scrubber.previewSeconds, i * 0.5f);
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:1.0 / updates]];
+    }
+    XCTAssertFalse(lastAllowSeekAhead);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"final seek"];
+    [scrubber endWithCompletion:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    
+    XCTAssertFalse(scrubber.isScrubbing);
+    XCTAssertEqual(maxInFlight, (NSUInteger)1);
+    XCTAssertTrue(lastAllowSeekAhead);
+    XCTAssertEqual(lastSeconds, updates * 0.5f);
+    XCTAssertEqual(scrubber.dispatchedSeekCount, evaluations);
+    XCTAssertLessThan(evaluations, updates / 3);
+}
+
+#pragma mark - YTPlayerResumeStore
+
+- (NSString *)temporaryResumeStorePath:(NSString *)name
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    return path;
+}
+
+- (void)testResumeStoreSurvivesReopenAndTornJournal
+{
+    NSString *path = [self temporaryResumeStorePath:@"YTPlayerResumeStoreTest"];
+    NSError *error = nil;
+    YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:&error];
+    XCTAssertNotNil(store, @"%@", error);
+    [store setPosition:12.5f forVideoId:@"M7lc1UVf-VE"];
+    [store setPosition:30.0f forVideoId:@"dQw4w9WgXcQ"];
+    XCTAssertTrue([store compact:&error], @"%@", error);
+    [store setPosition:45.0f forVideoId:@"M7lc1UVf-VE"];
+    [store removePositionForVideoId:@"dQw4w9WgXcQ"];
+    store = nil;
+    
+    // Simulate a crash in the middle of appending a record.
+    NSFileHandle *journal = [NSFileHandle fileHandleForWritingAtPath:[path stringByAppendingPathComponent:@"journal"]];
+    [journal seekToEndOfFile];
+    [journal writeData:[@"torn record" dataUsingEncoding:NSUTF8StringEncoding]];
+    [journal closeFile];
+    
+    store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:&error];
+    XCTAssertNotNil(store, @"%@", error);
+    XCTAssertEqual([store positionForVideoId:@"M7lc1UVf-VE"], 45.0f);
+    XCTAssertEqual([store positionForVideoId:@"dQw4w9WgXcQ"], 0.0f);
+    XCTAssertEqual([store positionForVideoId:@"unknown"], 0.0f);
+    
+    XCTAssertTrue([store compact:&error], @"%@", error);
+    XCTAssertEqual([store positionForVideoId:@"M7lc1UVf-VE"], 45.0f);
+    XCTAssertEqual([store positionForVideoId:@"dQw4w9WgXcQ"], 0.0f);
+}
+
+- (void)testResumeStoreCompactsInBackgroundWithoutLosingLaterUpdates
+{
+    NSString *path = [self temporaryResumeStorePath:@"YTPlayerResumeStoreBackgroundTest"];
+    NSString *journalPath = [path stringByAppendingPathComponent:@"journal"];
+    YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+    NSArray *videoIds = [self videoIdsWithCount:5000];
+    // The first 4096 updates start a background compaction. The rest are appended while it runs.
+    for (NSUInteger i = 0; i < videoIds.count; i++) {
+        [store setPosition:(float)i forVideoId:videoIds[i]];
+    }
+    
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:10.0];
+    unsigned long long journalSize = 0;
+    do {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+        journalSize = [[NSFileManager defaultManager] attributesOfItemAtPath:journalPath error:nil].fileSize;
+    } while (journalSize == videoIds.count * 32 && deadline.timeIntervalSinceNow > 0);
+    XCTAssertLessThan(journalSize, videoIds.count * 32, @"The journal has not been compacted");
+    XCTAssertEqual([store positionForVideoId:videoIds[0]], 0.0f);
+    XCTAssertEqual([store positionForVideoId:videoIds[4999]], 4999.0f);
+    
+    store = nil;
+    store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+    for (NSUInteger i = 0; i < videoIds.count; i++) {
+        XCTAssertEqual([store positionForVideoId:videoIds[i]], (float)i);
+    }
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+- (void)testResumeStoreIgnoresDamagedTableRecords
+{
+    NSString *path = [self temporaryResumeStorePath:@"YTPlayerResumeStoreDamageTest"];
+    YTPlayerResumeStore *store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+    [store setPosition:12.5f forVideoId:@"M7lc1UVf-VE"];
+    [store setPosition:30.0f forVideoId:@"dQw4w9WgXcQ"];
+    XCTAssertTrue([store compact:nil]);
+    store = nil;
+    
+    // Flip a bit of the stored seconds of one record.
+    NSString *tablePath = [path stringByAppendingPathComponent:@"table"];
+    NSMutableData *table = [NSMutableData dataWithContentsOfFile:tablePath];
+    NSRange range = [table rangeOfData:[@"M7lc1UVf-VE" dataUsingEncoding:NSUTF8StringEncoding] options:0 range:NSMakeRange(0, table.length)];
+    XCTAssertNotEqual(range.location, (NSUInteger)NSNotFound);
+    ((uint8_t *)table.mutableBytes)[range.location + 24] ^= 0x01;
+    XCTAssertTrue([table writeToFile:tablePath atomically:NO]);
+    
+    store = [[YTPlayerResumeStore alloc] initWithDirectoryPath:path error:nil];
+    XCTAssertEqual([store positionForVideoId:@"M7lc1UVf-VE"], 0.0f);
+    XCTAssertEqual([store positionForVideoId:@"dQw4w9WgXcQ"], 30.0f);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+#pragma mark - YTPlayerQualityController
+
+- (void)testQualityControllerStepsDownOnCongestedTrace
+{
+    YTPlayerQualityController *controller = [[YTPlayerQualityController alloc] init];
+    [controller playerDidChangeToQuality:YTPlaybackQualityHD720 atTime:0];
+    [controller playerDidChangeToState:YTPlayerStatePlaying atTime:0];
+    
+    // Congested link: playback stalls for 3 seconds every 15 seconds while buffering slower than real time.
+    NSMutableArray<YTPlayerQualityDecision *> *decisions = [NSMutableArray array];
+    NSTimeInterval buffered = 0;
+    for (NSTimeInterval t = 1; t <= 120; t += 1) {
+        YTPlayerQualityDecision *decision = nil;
+        NSInteger phase = (NSInteger)t % 15;
+        if (phase == 0) {
+            decision = [controller playerDidChangeToState:YTPlayerStateBuffering atTime:t];
+        } else if (phase == 3) {
+            decision = [controller playerDidChangeToState:YTPlayerStatePlaying atTime:t];
+        } else {
+            buffered += 0.8;
+            decision = [controller playerDidBufferSeconds:buffered playTime:buffered - 1 atTime:t];
+        }
+        if (decision != nil) {
+            [decisions addObject:decision];
+        }
+    }
+    
+    XCTAssertEqual(decisions.count, (NSUInteger)3);
+    XCTAssertEqual(controller.currentQuality, YTPlaybackQualitySmall);
+    for (NSUInteger i = 0; i < decisions.count; i++) {
+        XCTAssertEqual(decisions[i].toQuality, decisions[i].fromQuality - 1);
+        XCTAssertEqual(decisions[i].reason, YTPlayerQualityChangeReasonFrequentStalls);
+        if (i > 0) {
+            XCTAssertGreaterThanOrEqual(decisions[i].time - decisions[i - 1].time, controller.minimumSwitchInterval);
+        }
+    }
+}
+
+- (void)testQualityControllerBacksOffAfterFailedStepUp
+{
+    YTPlayerQualityController *controller = [[YTPlayerQualityController alloc] init];
+    [controller playerDidChangeToQuality:YTPlaybackQualityMedium atTime:0];
+    [controller playerDidChangeToState:YTPlayerStatePlaying atTime:0];
+    
+    // Healthy link: buffering twice as fast as real time.
+    YTPlayerQualityDecision *upgrade = nil;
+    for (NSTimeInterval t = 2; t <= 64 && upgrade == nil; t += 2) {
+        upgrade = [controller playerDidBufferSeconds:t * 2 playTime:t atTime:t];
+    }
+    XCTAssertEqual(upgrade.toQuality, YTPlaybackQualityLarge);
+    XCTAssertEqual(upgrade.reason, YTPlayerQualityChangeReasonHealthyBuffer);
+    XCTAssertGreaterThanOrEqual(upgrade.time, controller.upgradeStableInterval);
+    
+    // The higher quality stalls for 6 seconds right away.
+    [controller playerDidChangeToState:YTPlayerStateBuffering atTime:65];
+    XCTAssertNil([controller evaluateAtTime:69], @"Must not switch within minimumSwitchInterval");
+    YTPlayerQualityDecision *downgrade = [controller evaluateAtTime:70];
+    XCTAssertEqual(downgrade.toQuality, YTPlaybackQualityMedium);
+    XCTAssertEqual(downgrade.reason, YTPlayerQualityChangeReasonLongStall);
+    XCTAssertEqual(controller.upgradeBackoff, (NSUInteger)2);
+    [controller playerDidChangeToState:YTPlayerStatePlaying atTime:71];
+    
+    // Stepping up again now takes twice as long.
+    upgrade = nil;
+    for (NSTimeInterval t = 72; t <= 240 && upgrade == nil; t += 2) {
+        upgrade = [controller playerDidBufferSeconds:t * 2 playTime:t atTime:t];
+    }
+    XCTAssertEqual(upgrade.toQuality, YTPlaybackQualityLarge);
+    XCTAssertGreaterThanOrEqual(upgrade.time, 71 + controller.upgradeStableInterval * 2);
+}
+
+- (void)testQualityControllerIgnoresBufferingCausedByItsOwnSwitches
+{
+    YTPlayerQualityController *controller = [[YTPlayerQualityController alloc] init];
+    [controller playerDidChangeToQuality:YTPlaybackQualityMedium atTime:0];
+    [controller playerDidChangeToState:YTPlayerStatePlaying atTime:0];
+    
+    // Healthy link, except for a single short rebuffer at 90 seconds. Every switch makes the player buffer briefly.
+    NSMutableArray<YTPlayerQualityDecision *> *decisions = [NSMutableArray array];
+    for (NSTimeInterval t = 2; t <= 240; t += 2) {
+        YTPlayerQualityDecision *decision = [controller playerDidBufferSeconds:t * 2 playTime:t atTime:t];
+        if (t == 90) {
+            XCTAssertNil([controller playerDidChangeToState:YTPlayerStateBuffering atTime:t]);
+            XCTAssertNil([controller playerDidChangeToState:YTPlayerStatePlaying atTime:t + 1]);
+        }
+        if (decision != nil) {
+            [decisions addObject:decision];
+            XCTAssertNil([controller playerDidChangeToState:YTPlayerStateBuffering atTime:t + 0.5]);
+            XCTAssertNil([controller playerDidChangeToState:YTPlayerStatePlaying atTime:t + 1.5]);
+        }
+    }
+    
+    XCTAssertEqual(decisions.count, (NSUInteger)3);
+    for (YTPlayerQualityDecision *decision in decisions) {
+        XCTAssertEqual(decision.reason, YTPlayerQualityChangeReasonHealthyBuffer);
+        XCTAssertEqual(decision.toQuality, decision.fromQuality + 1);
+    }
+    XCTAssertEqual(controller.currentQuality, YTPlaybackQualityHD1080);
+    XCTAssertEqual(controller.upgradeBackoff, (NSUInteger)1);
+}
+
+- (void)testQualityControllerKeepsSteppingDownDuringOneLongStall
+{
+    YTPlayerQualityController *controller = [[YTPlayerQualityController alloc] init];
+    [controller playerDidChangeToQuality:YTPlaybackQualityHD720 atTime:0];
+    [controller playerDidChangeToState:YTPlayerStatePlaying atTime:0];
+    
+    // The player reports nothing while stalled, so YTPlayerView keeps calling -evaluateAtTime: until the stall ends.
+    [controller playerDidChangeToState:YTPlayerStateBuffering atTime:20];
+    XCTAssertEqual([controller evaluateAtTime:24].toQuality, YTPlaybackQualityLarge);
+    XCTAssertNil([controller evaluateAtTime:30], @"Must not switch within minimumSwitchInterval");
+    YTPlayerQualityDecision *decision = [controller evaluateAtTime:34];
+    XCTAssertEqual(decision.toQuality, YTPlaybackQualityMedium);
+    XCTAssertEqual(decision.reason, YTPlayerQualityChangeReasonLongStall);
+}
+
+- (void)testQualityControllerPerformanceOnDayLongTrace
+{
+    [self measureBlock:^{
+        YTPlayerQualityController *controller = [[YTPlayerQualityController alloc] init];
+        [controller playerDidChangeToQuality:YTPlaybackQualityHD720 atTime:0];
+        [controller playerDidChangeToState:YTPlayerStatePlaying atTime:0];
+        // A day of playback sampled every second, with a congested hour every four hours.
+        for (NSUInteger t = 1; t <= 24 * 3600; t++) {
+            BOOL congested = (t / 3600) % 4 == 0;
+            if (congested && t % 20 == 0) {
+                [controller playerDidChangeToState:YTPlayerStateBuffering atTime:t];
+            } else if (congested && t % 20 == 3) {
+                [controller playerDidChangeToState:YTPlayerStatePlaying atTime:t];
+            } else {
+                [controller playerDidBufferSeconds:t * (congested ? 0.9 : 2.0) playTime:t atTime:t];
+            }
+        }
+    }];
+}
+
+@end
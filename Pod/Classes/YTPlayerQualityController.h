@@ -0,0 +1,181 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YTPlayerView.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+#pragma mark - Enums/Constants definitions
+
+
+/// Enums that represents why YTPlayerQualityController has changed the playback quality.
+typedef NS_ENUM(NSInteger, YTPlayerQualityChangeReason) {
+    YTPlayerQualityChangeReasonFrequentStalls,  /// Too many or too long rebuffers in the recent window. Steps down.
+    YTPlayerQualityChangeReasonLongStall,       /// A single rebuffer has lasted too long. Steps down.
+    YTPlayerQualityChangeReasonHealthyBuffer,   /// No rebuffers for a while and the buffer grows fast enough. Steps up.
+};
+
+
+#pragma mark - YTPlayerQualityDecision
+
+
+/** A playback quality change decided by YTPlayerQualityController. */
+@interface YTPlayerQualityDecision : NSObject
+
+- (instancetype)initWithFromQuality:(YTPlaybackQuality)fromQuality
+                          toQuality:(YTPlaybackQuality)toQuality
+                             reason:(YTPlayerQualityChangeReason)reason
+                               time:(NSTimeInterval)time NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) YTPlaybackQuality fromQuality;
+@property (nonatomic, readonly) YTPlaybackQuality toQuality;
+@property (nonatomic, readonly) YTPlayerQualityChangeReason reason;
+/** The timestamp of the event that caused this decision. */
+@property (nonatomic, readonly) NSTimeInterval time;
+
+@end
+
+
+#pragma mark - YTPlayerQualityController
+
+
+/**
+ * YTPlayerQualityController decides when to step the playback quality down or up from
+ * buffering telemetry: how often and how long playback rebuffers, and how fast the loaded
+ * part of the video grows.
+ *
+ * It is a pure state machine. It never reads a clock nor talks to the player; every input comes
+ * with its own timestamp and every decision is returned to the caller. This makes it possible to
+ * replay simulated network traces headlessly. Use it through `YTPlayerView.qualityController`,
+ * which feeds the player events and applies the decisions.
+ *
+ * Switches are damped by hysteresis: two switches are always at least `minimumSwitchInterval`
+ * apart, and stepping up requires `upgradeStableInterval` without rebuffers. If a step up is
+ * followed by a step down before that interval passes again, the interval required for the next
+ * step up doubles, up to `maximumUpgradeBackoff` times.
+ */
+@interface YTPlayerQualityController : NSObject
+
+#pragma mark - Configuration
+
+/** The duration in seconds of the window where rebuffers are counted. Default value is 60. */
+@property (nonatomic) NSTimeInterval stallWindow;
+
+/** The number of rebuffers in `stallWindow` that causes a step down. Default value is 2. */
+@property (nonatomic) NSUInteger downgradeStallCount;
+
+/** The total duration in seconds of rebuffers in `stallWindow` that causes a step down. Default value is 8. */
+@property (nonatomic) NSTimeInterval downgradeStallDuration;
+
+/** The duration in seconds of a single ongoing rebuffer that causes a step down. Default value is 4. */
+@property (nonatomic) NSTimeInterval longStallDuration;
+
+/** The minimum interval in seconds between two switches. Default value is 10. */
+@property (nonatomic) NSTimeInterval minimumSwitchInterval;
+
+/** The interval in seconds without rebuffers required before stepping up. Default value is 60. */
+@property (nonatomic) NSTimeInterval upgradeStableInterval;
+
+/** The maximum multiplier applied to `upgradeStableInterval` after failed step ups. Default value is 8. */
+@property (nonatomic) NSUInteger maximumUpgradeBackoff;
+
+/**
+ * The ratio of buffered video seconds per wall clock second that is fast enough to step up.
+ * Default value is 1.5.
+ */
+@property (nonatomic) double upgradeBufferRatio;
+
+/**
+ * The number of seconds buffered ahead of the play time that is enough to step up regardless of
+ * `upgradeBufferRatio`, because the player stops buffering once it is far enough ahead.
+ * Default value is 30.
+ */
+@property (nonatomic) NSTimeInterval upgradeBufferAhead;
+
+/**
+ * Buffering within this interval in seconds after a seek or a quality switch is not counted as a rebuffer.
+ * Default value is 2.
+ */
+@property (nonatomic) NSTimeInterval seekGraceInterval;
+
+/** The lowest quality to step down to. Default value is YTPlaybackQualitySmall. */
+@property (nonatomic) YTPlaybackQuality minimumQuality;
+
+/** The highest quality to step up to. Default value is YTPlaybackQualityHD1080. */
+@property (nonatomic) YTPlaybackQuality maximumQuality;
+
+/**
+ * The qualities of the current video as returned by YTPlayerView::availableQualityLevels:, or nil
+ * to consider every quality between `minimumQuality` and `maximumQuality` available.
+ */
+@property (nonatomic, copy, nullable) NSArray<NSNumber *> *availableQualities;
+
+#pragma mark - State
+
+/** The current playback quality, or YTPlaybackQualityUnknown until the player reports one. */
+@property (nonatomic, readonly) YTPlaybackQuality currentQuality;
+
+/** The multiplier currently applied to `upgradeStableInterval`. */
+@property (nonatomic, readonly) NSUInteger upgradeBackoff;
+
+/**
+ * Forgets everything about the current video, e.g. when another video is loaded.
+ * The upgrade backoff is kept, since it describes the network rather than the video.
+ */
+- (void)reset;
+
+#pragma mark - Events
+
+/**
+ * Feeds a player state change.
+ *
+ * @return A decision to change the playback quality, or nil.
+ */
+- (nullable YTPlayerQualityDecision *)playerDidChangeToState:(YTPlayerState)state atTime:(NSTimeInterval)time;
+
+/**
+ * Feeds the playback quality reported by the player.
+ */
+- (void)playerDidChangeToQuality:(YTPlaybackQuality)quality atTime:(NSTimeInterval)time;
+
+/**
+ * Feeds a seek, so that the buffering it causes is not taken as a rebuffer.
+ */
+- (void)playerDidSeekAtTime:(NSTimeInterval)time;
+
+/**
+ * Feeds a sample of the loaded part of the video, i.e. `videoLoadedFraction` times the duration.
+ *
+ * @param bufferedSeconds The number of seconds of the video loaded so far.
+ * @param playTime The current play time in seconds.
+ * @return A decision to change the playback quality, or nil.
+ */
+- (nullable YTPlayerQualityDecision *)playerDidBufferSeconds:(NSTimeInterval)bufferedSeconds
+                                                    playTime:(NSTimeInterval)playTime
+                                                      atTime:(NSTimeInterval)time;
+
+/**
+ * Re-evaluates the state without a new event, e.g. to catch a long ongoing rebuffer.
+ *
+ * @return A decision to change the playback quality, or nil.
+ */
+- (nullable YTPlayerQualityDecision *)evaluateAtTime:(NSTimeInterval)time;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,259 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YTPlayerQualityController.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Weight of the newest sample in the moving average of the buffer growth ratio.
+double static const YTPlayerQualityBufferRatioSmoothing = 0.3;
+
+@implementation YTPlayerQualityDecision
+
+- (instancetype)initWithFromQuality:(YTPlaybackQuality)fromQuality
+                          toQuality:(YTPlaybackQuality)toQuality
+                             reason:(YTPlayerQualityChangeReason)reason
+                               time:(NSTimeInterval)time {
+    self = [super init];
+    if (self) {
+        _fromQuality = fromQuality;
+        _toQuality = toQuality;
+        _reason = reason;
+        _time = time;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; fromQuality = %@; toQuality = %@; reason = %@; time = %@>",
+            NSStringFromClass([self class]), self, @(self.fromQuality), @(self.toQuality), @(self.reason), @(self.time)];
+}
+
+@end
+
+#pragma mark -
+
+
+@interface YTPlayerQualityController()
+
+@property (nonatomic) YTPlaybackQuality currentQuality;
+@property (nonatomic) NSUInteger upgradeBackoff;
+
+@property (nonatomic) YTPlayerState lastState;
+@property (nonatomic) NSTimeInterval stallStartTime;   // NAN unless rebuffering now.
+@property (nonatomic) NSTimeInterval stableSinceTime;  // NAN until playback starts.
+@property (nonatomic) NSTimeInterval lastSeekTime;
+@property (nonatomic) NSTimeInterval lastSwitchTime;
+@property (nonatomic) NSTimeInterval lastUpgradeTime;
+@property (nonatomic) NSTimeInterval lastDowngradeTime;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *stallStartTimes;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *stallDurations;
+
+@property (nonatomic) NSTimeInterval lastBufferedSeconds;  // NAN until the first sample.
+@property (nonatomic) NSTimeInterval lastBufferSampleTime;
+@property (nonatomic) double bufferRatio;                  // NAN until two samples.
+@property (nonatomic) NSTimeInterval bufferAhead;
+
+@end
+
+@implementation YTPlayerQualityController
+
+#pragma mark - Init/dealloc
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _stallWindow = 60.0;
+        _downgradeStallCount = 2;
+        _downgradeStallDuration = 8.0;
+        _longStallDuration = 4.0;
+        _minimumSwitchInterval = 10.0;
+        _upgradeStableInterval = 60.0;
+        _maximumUpgradeBackoff = 8;
+        _upgradeBufferRatio = 1.5;
+        _upgradeBufferAhead = 30.0;
+        _seekGraceInterval = 2.0;
+        _minimumQuality = YTPlaybackQualitySmall;
+        _maximumQuality = YTPlaybackQualityHD1080;
+        _currentQuality = YTPlaybackQualityUnknown;
+        _upgradeBackoff = 1;
+        _lastSwitchTime = -DBL_MAX;
+        _lastUpgradeTime = -DBL_MAX;
+        _lastDowngradeTime = -DBL_MAX;
+        _stallStartTimes = [NSMutableArray array];
+        _stallDurations = [NSMutableArray array];
+        [self reset];
+    }
+    return self;
+}
+
+- (void)reset {
+    self.lastState = YTPlayerStateUnknown;
+    self.stallStartTime = NAN;
+    self.stableSinceTime = NAN;
+    self.lastSeekTime = -DBL_MAX;
+    [self.stallStartTimes removeAllObjects];
+    [self.stallDurations removeAllObjects];
+    self.lastBufferedSeconds = NAN;
+    self.lastBufferSampleTime = NAN;
+    self.bufferRatio = NAN;
+    self.bufferAhead = 0;
+    self.availableQualities = nil;
+}
+
+#pragma mark - Events
+
+- (nullable YTPlayerQualityDecision *)playerDidChangeToState:(YTPlayerState)state atTime:(NSTimeInterval)time {
+    if (state == YTPlayerStateBuffering) {
+        // Buffering right after starting, seeking or switching quality is expected. Only buffering that interrupts
+        // playback is a rebuffer. Counting the buffering caused by our own switches would make them look failed.
+        if (self.lastState == YTPlayerStatePlaying &&
+            time - self.lastSeekTime > self.seekGraceInterval &&
+            time - self.lastSwitchTime > self.seekGraceInterval) {
+            self.stallStartTime = time;
+        }
+    } else if (!isnan(self.stallStartTime)) {
+        if (state == YTPlayerStatePlaying || state == YTPlayerStatePaused) {
+            [self.stallStartTimes addObject:@(self.stallStartTime)];
+            [self.stallDurations addObject:@(time - self.stallStartTime)];
+            self.stableSinceTime = time;
+        }
+        self.stallStartTime = NAN;
+    }
+    if (state == YTPlayerStatePlaying && isnan(self.stableSinceTime)) {
+        self.stableSinceTime = time;
+    }
+    self.lastState = state;
+    return [self evaluateAtTime:time];
+}
+
+- (void)playerDidChangeToQuality:(YTPlaybackQuality)quality atTime:(NSTimeInterval)time {
+    if (quality > YTPlaybackQualityHighRes) {
+        // Auto, default or unknown. There is nothing to step from.
+        return;
+    }
+    self.currentQuality = quality;
+}
+
+- (void)playerDidSeekAtTime:(NSTimeInterval)time {
+    self.lastSeekTime = time;
+    // The loaded part of the video may jump anywhere after a seek.
+    self.lastBufferedSeconds = NAN;
+}
+
+- (nullable YTPlayerQualityDecision *)playerDidBufferSeconds:(NSTimeInterval)bufferedSeconds
+                                                    playTime:(NSTimeInterval)playTime
+                                                      atTime:(NSTimeInterval)time {
+    if (!isnan(self.lastBufferedSeconds) && time > self.lastBufferSampleTime && bufferedSeconds >= self.lastBufferedSeconds) {
+        double ratio = (bufferedSeconds - self.lastBufferedSeconds) / (time - self.lastBufferSampleTime);
+        self.bufferRatio = isnan(self.bufferRatio) ? ratio : (YTPlayerQualityBufferRatioSmoothing * ratio + (1.0 - YTPlayerQualityBufferRatioSmoothing) * self.bufferRatio);
+    }
+    self.lastBufferedSeconds = bufferedSeconds;
+    self.lastBufferSampleTime = time;
+    self.bufferAhead = MAX(bufferedSeconds - playTime, 0.0);
+    return [self evaluateAtTime:time];
+}
+
+- (nullable YTPlayerQualityDecision *)evaluateAtTime:(NSTimeInterval)time {
+    if (self.currentQuality > YTPlaybackQualityHighRes || time - self.lastSwitchTime < self.minimumSwitchInterval) {
+        return nil;
+    }
+
+    // Forget rebuffers that have fallen out of the window.
+    while (self.stallStartTimes.count > 0 && self.stallStartTimes.firstObject.doubleValue < time - self.stallWindow) {
+        [self.stallStartTimes removeObjectAtIndex:0];
+        [self.stallDurations removeObjectAtIndex:0];
+    }
+    NSTimeInterval ongoingStallDuration = isnan(self.stallStartTime) ? 0 : time - self.stallStartTime;
+    NSUInteger stallCount = self.stallStartTimes.count + (isnan(self.stallStartTime) ? 0 : 1);
+    NSTimeInterval stallDuration = ongoingStallDuration;
+    for (NSNumber *duration in self.stallDurations) {
+        stallDuration += duration.doubleValue;
+    }
+
+    if (ongoingStallDuration >= self.longStallDuration) {
+        return [self stepDownAtTime:time reason:YTPlayerQualityChangeReasonLongStall];
+    }
+    if (stallCount >= self.downgradeStallCount || stallDuration >= self.downgradeStallDuration) {
+        return [self stepDownAtTime:time reason:YTPlayerQualityChangeReasonFrequentStalls];
+    }
+
+    BOOL stable = (!isnan(self.stableSinceTime) && isnan(self.stallStartTime) &&
+                   time - self.stableSinceTime >= self.upgradeStableInterval * self.upgradeBackoff);
+    BOOL bufferHealthy = ((!isnan(self.bufferRatio) && self.bufferRatio >= self.upgradeBufferRatio) ||
+                          self.bufferAhead >= self.upgradeBufferAhead);
+    if (stable && bufferHealthy) {
+        return [self stepUpAtTime:time];
+    }
+    return nil;
+}
+
+#pragma mark - Private methods
+
+- (BOOL)isQualityAvailable:(YTPlaybackQuality)quality {
+    if (quality < self.minimumQuality || quality > self.maximumQuality) {
+        return NO;
+    }
+    return (self.availableQualities.count == 0 || [self.availableQualities containsObject:@(quality)]);
+}
+
+- (nullable YTPlayerQualityDecision *)stepDownAtTime:(NSTimeInterval)time reason:(YTPlayerQualityChangeReason)reason {
+    for (NSInteger quality = self.currentQuality - 1; quality >= YTPlaybackQualitySmall; quality--) {
+        if ([self isQualityAvailable:quality]) {
+            if (time - self.lastUpgradeTime < self.upgradeStableInterval * self.upgradeBackoff) {
+                // The last step up didn't hold. Be more careful before trying again.
+                self.upgradeBackoff = MIN(self.upgradeBackoff * 2, MAX(self.maximumUpgradeBackoff, (NSUInteger)1));
+            }
+            self.lastDowngradeTime = time;
+            return [self switchToQuality:quality atTime:time reason:reason];
+        }
+    }
+    return nil;
+}
+
+- (nullable YTPlayerQualityDecision *)stepUpAtTime:(NSTimeInterval)time {
+    for (NSInteger quality = self.currentQuality + 1; quality <= YTPlaybackQualityHighRes; quality++) {
+        if ([self isQualityAvailable:quality]) {
+            if (self.lastUpgradeTime > self.lastDowngradeTime) {
+                // The last step up has held, so relax the backoff.
+                self.upgradeBackoff = MAX(self.upgradeBackoff / 2, (NSUInteger)1);
+            }
+            self.lastUpgradeTime = time;
+            return [self switchToQuality:quality atTime:time reason:YTPlayerQualityChangeReasonHealthyBuffer];
+        }
+    }
+    return nil;
+}
+
+- (YTPlayerQualityDecision *)switchToQuality:(YTPlaybackQuality)quality atTime:(NSTimeInterval)time reason:(YTPlayerQualityChangeReason)reason {
+    YTPlayerQualityDecision *decision = [[YTPlayerQualityDecision alloc] initWithFromQuality:self.currentQuality
+                                                                                   toQuality:quality
+                                                                                      reason:reason
+                                                                                        time:time];
+    self.currentQuality = quality;
+    self.lastSwitchTime = time;
+    // Judge the new quality on its own rebuffers.
+    [self.stallStartTimes removeAllObjects];
+    [self.stallDurations removeAllObjects];
+    if (!isnan(self.stallStartTime)) {
+        self.stallStartTime = time;
+    }
+    self.stableSinceTime = time;
+    self.bufferRatio = NAN;
+    return decision;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,189 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+#pragma mark - Enums/Constants definitions
+
+
+/// Enums that represents how YTPlayerQueue behaves when it reaches either end of the play order.
+typedef NS_ENUM(NSInteger, YTPlayerQueueLoopMode) {
+    YTPlayerQueueLoopModeNone,  /// Stops at the end of the queue.
+    YTPlayerQueueLoopModeOne,   /// Repeats the current video. Explicit next/previous still move through the queue.
+    YTPlayerQueueLoopModeAll,   /// Wraps around to the other end of the queue.
+};
+
+
+#pragma mark - YTPlayerQueue
+
+
+/**
+ * YTPlayerQueue is a native model of an arbitrarily long list of video IDs.
+ *
+ * The queue keeps its own play order (either the given order, or a shuffled permutation
+ * reproducible from a seed) and the current position in that order, so moving to the next
+ * or previous video is O(1) regardless of the length of the queue.
+ *
+ * YTPlayerView never sends the whole queue to the iframe player. Instead it loads a *window*,
+ * a short run of consecutive positions around the current one, using `player.loadPlaylist()`,
+ * and slides it as playback moves forward. See `-windowAroundPosition:` for details.
+ *
+ * `loopMode`, `shuffled` and `shuffleSeed` are key-value observable, which YTPlayerView relies on
+ * to follow changes of the play order while the queue is being played.
+ *
+ * This class doesn't depend on UIKit or WebKit and can be used and tested headlessly.
+ */
+@interface YTPlayerQueue : NSObject
+
+/**
+ * Initializes a new queue with the given video IDs in the given order.
+ *
+ * @param videoIds An array of YouTube video IDs. The array is copied.
+ */
+- (instancetype)initWithVideoIds:(NSArray<NSString *> *)videoIds NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/** All video IDs of this queue in their original order. */
+@property (nonatomic, copy, readonly) NSArray<NSString *> *videoIds;
+
+/** The number of videos in this queue. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** The loop behavior of this queue. Default value is YTPlayerQueueLoopModeNone. */
+@property (nonatomic) YTPlayerQueueLoopMode loopMode;
+
+/**
+ * The maximum number of video IDs YTPlayerView passes to the iframe player at once.
+ * Default value is 50, which is small enough to keep the JavaScript bridge cheap. Must not be 0.
+ * Windows always hold at least 3 videos, so values below 3 behave like 3.
+ */
+@property (nonatomic) NSUInteger windowSize;
+
+/** The current 0-indexed position in the play order. Always 0 for an empty queue. */
+@property (nonatomic) NSUInteger currentPosition;
+
+/** The video ID at the current position, or nil if the queue is empty. */
+@property (nonatomic, readonly, nullable) NSString *currentVideoId;
+
+/** A Boolean value indicating whether the play order is currently shuffled. */
+@property (nonatomic, readonly, getter=isShuffled) BOOL shuffled;
+
+/** The seed of the current shuffled play order. Meaningless if the queue is not shuffled. */
+@property (nonatomic, readonly) uint64_t shuffleSeed;
+
+#pragma mark - Play order
+
+/**
+ * Shuffles the play order into the permutation derived from the given seed.
+ * The same seed always produces the same permutation for queues of the same length.
+ * The current video keeps being current; `currentPosition` is moved to where it landed.
+ *
+ * @param seed A seed for the permutation.
+ */
+- (void)shuffleWithSeed:(uint64_t)seed;
+
+/**
+ * Restores the original play order. The current video keeps being current.
+ */
+- (void)unshuffle;
+
+/**
+ * Returns the index in `videoIds` of the video at the given position in the play order.
+ *
+ * @param position A position in the play order. Must be less than `count`.
+ */
+- (NSUInteger)videoIndexAtPosition:(NSUInteger)position;
+
+/**
+ * Returns the video ID at the given position in the play order, or nil if out of bounds.
+ */
+- (nullable NSString *)videoIdAtPosition:(NSUInteger)position;
+
+#pragma mark - Navigation
+
+/**
+ * Returns the position following the current one according to `loopMode`,
+ * or NSNotFound if the current position is the last one and the queue doesn't loop.
+ */
+- (NSUInteger)nextPosition;
+
+/**
+ * Returns the position preceding the current one according to `loopMode`,
+ * or NSNotFound if the current position is the first one and the queue doesn't loop.
+ */
+- (NSUInteger)previousPosition;
+
+/**
+ * Moves to `-nextPosition`.
+ *
+ * @return YES if the current position has been moved, NO if there's no next position.
+ */
+- (BOOL)advance;
+
+/**
+ * Moves to `-previousPosition`.
+ *
+ * @return YES if the current position has been moved, NO if there's no previous position.
+ */
+- (BOOL)retreat;
+
+#pragma mark - Windowing
+
+/**
+ * Returns the window of positions that should be loaded into the iframe player while the
+ * video at the given position is playing.
+ *
+ * `location` is the first position of the window and `length` is its number of videos. When
+ * `loopMode` is YTPlayerQueueLoopModeAll the window may run past the end of the play order, in
+ * which case positions wrap around modulo `count`. When `loopMode` is YTPlayerQueueLoopModeOne
+ * the window only contains the given position, so the iframe player can loop it by itself.
+ *
+ * @param position A position in the play order.
+ */
+- (NSRange)windowAroundPosition:(NSUInteger)position;
+
+/**
+ * Returns the video IDs of the given window, in play order.
+ */
+- (NSArray<NSString *> *)videoIdsInWindow:(NSRange)window;
+
+/**
+ * Maps an index in the iframe player's playlist (as returned by `player.getPlaylistIndex()`)
+ * back to the global position in the play order.
+ *
+ * @return The global position, or NSNotFound if the index is out of the window.
+ */
+- (NSUInteger)positionForIndex:(NSInteger)index inWindow:(NSRange)window;
+
+/**
+ * Maps a global position in the play order to an index in the iframe player's playlist.
+ *
+ * @return The index in the window, or NSNotFound if the position is out of the window.
+ */
+- (NSUInteger)indexForPosition:(NSUInteger)position inWindow:(NSRange)window;
+
+/**
+ * Returns whether the given window has to be replaced once the video at the given position
+ * starts playing, i.e. the position is out of the window, or is at an edge of the window
+ * while the queue has more videos beyond that edge.
+ */
+- (BOOL)window:(NSRange)window needsSlidingForPosition:(NSUInteger)position;
+
+@end
+
+NS_ASSUME_NONNULL_END
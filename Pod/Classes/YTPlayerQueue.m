@@ -0,0 +1,267 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YTPlayerQueue.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Default number of video IDs passed to the iframe player at once.
+NSUInteger static const YTPlayerQueueDefaultWindowSize = 50;
+// Smallest window that can hold the current video with a neighbor on each side.
+NSUInteger static const YTPlayerQueueMinimumWindowSize = 3;
+
+/**
+ * Private function to generate the next value of SplitMix64 pseudo random number generator.
+ * We don't use arc4random() because the shuffled order must be reproducible from the seed.
+ *
+ * @param state The generator state, updated in place.
+ * @return A 64-bit pseudo random value.
+ */
+static uint64_t YTPlayerQueueNextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#pragma mark -
+
+
+@interface YTPlayerQueue()
+
+// Shuffled play order, an array of NSUInteger indices into `videoIds`. nil while not shuffled.
+@property (nonatomic, strong, nullable) NSMutableData *permutation;
+@property (nonatomic) uint64_t shuffleSeed;
+
+@end
+
+@implementation YTPlayerQueue
+
+#pragma mark - Init/dealloc
+
+- (instancetype)initWithVideoIds:(NSArray<NSString *> *)videoIds {
+    self = [super init];
+    if (self) {
+        _videoIds = [videoIds copy];
+        _windowSize = YTPlayerQueueDefaultWindowSize;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; count = %@; currentPosition = %@; shuffled = %@; loopMode = %@>",
+            NSStringFromClass([self class]), self, @(self.count), @(self.currentPosition), @(self.shuffled), @(self.loopMode)];
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)count {
+    return self.videoIds.count;
+}
+
+- (void)setWindowSize:(NSUInteger)windowSize {
+    NSParameterAssert(windowSize > 0);
+    _windowSize = MAX(windowSize, (NSUInteger)1);
+}
+
+- (void)setCurrentPosition:(NSUInteger)currentPosition {
+    NSParameterAssert(currentPosition < self.count || self.count == 0);
+    _currentPosition = (self.count == 0) ? 0 : MIN(currentPosition, self.count - 1);
+}
+
+- (nullable NSString *)currentVideoId {
+    return [self videoIdAtPosition:self.currentPosition];
+}
+
+- (BOOL)isShuffled {
+    return (self.permutation != nil);
+}
+
++ (NSSet<NSString *> *)keyPathsForValuesAffectingShuffled {
+    return [NSSet setWithObject:@"permutation"];
+}
+
+#pragma mark - Play order
+
+- (void)shuffleWithSeed:(uint64_t)seed {
+    NSUInteger count = self.count;
+    NSUInteger currentIndex = (count == 0) ? 0 : [self videoIndexAtPosition:self.currentPosition];
+
+    NSMutableData *permutation = [NSMutableData dataWithLength:count * sizeof(NSUInteger)];
+    NSUInteger *order = permutation.mutableBytes;
+    for (NSUInteger i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    // Fisher-Yates shuffle.
+    uint64_t state = seed;
+    for (NSUInteger i = count; i > 1; i--) {
+        NSUInteger j = (NSUInteger)(YTPlayerQueueNextRandom(&state) % i);
+        NSUInteger tmp = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = tmp;
+    }
+
+    self.permutation = permutation;
+    self.shuffleSeed = seed;
+
+    for (NSUInteger position = 0; position < count; position++) {
+        if (order[position] == currentIndex) {
+            self.currentPosition = position;
+            break;
+        }
+    }
+}
+
+- (void)unshuffle {
+    if (self.permutation == nil) {
+        return;
+    }
+    NSUInteger currentIndex = (self.count == 0) ? 0 : [self videoIndexAtPosition:self.currentPosition];
+    self.permutation = nil;
+    self.shuffleSeed = 0;
+    self.currentPosition = currentIndex;
+}
+
+- (NSUInteger)videoIndexAtPosition:(NSUInteger)position {
+    NSParameterAssert(position < self.count);
+    if (self.permutation == nil) {
+        return position;
+    }
+    const NSUInteger *order = self.permutation.bytes;
+    return order[position];
+}
+
+- (nullable NSString *)videoIdAtPosition:(NSUInteger)position {
+    if (position >= self.count) {
+        return nil;
+    }
+    return self.videoIds[[self videoIndexAtPosition:position]];
+}
+
+#pragma mark - Navigation
+
+- (NSUInteger)nextPosition {
+    NSUInteger count = self.count;
+    if (count == 0) {
+        return NSNotFound;
+    }
+    if (self.currentPosition + 1 < count) {
+        return self.currentPosition + 1;
+    }
+    // Explicit skipping on YTPlayerQueueLoopModeOne behaves just like YTPlayerQueueLoopModeAll.
+    return (self.loopMode == YTPlayerQueueLoopModeNone) ? NSNotFound : 0;
+}
+
+- (NSUInteger)previousPosition {
+    NSUInteger count = self.count;
+    if (count == 0) {
+        return NSNotFound;
+    }
+    if (self.currentPosition > 0) {
+        return self.currentPosition - 1;
+    }
+    return (self.loopMode == YTPlayerQueueLoopModeNone) ? NSNotFound : count - 1;
+}
+
+- (BOOL)advance {
+    NSUInteger position = [self nextPosition];
+    if (position == NSNotFound) {
+        return NO;
+    }
+    self.currentPosition = position;
+    return YES;
+}
+
+- (BOOL)retreat {
+    NSUInteger position = [self previousPosition];
+    if (position == NSNotFound) {
+        return NO;
+    }
+    self.currentPosition = position;
+    return YES;
+}
+
+#pragma mark - Windowing
+
+- (NSRange)windowAroundPosition:(NSUInteger)position {
+    NSUInteger count = self.count;
+    if (count == 0) {
+        return NSMakeRange(0, 0);
+    }
+    NSParameterAssert(position < count);
+    if (self.loopMode == YTPlayerQueueLoopModeOne) {
+        return NSMakeRange(position, 1);
+    }
+    // A window needs room for the current video plus one on each side, otherwise the current
+    // position always sits on an edge and the window would have to slide as soon as it is loaded.
+    NSUInteger length = MIN(MAX(self.windowSize, YTPlayerQueueMinimumWindowSize), count);
+    if (length == count) {
+        return NSMakeRange(0, count);
+    }
+    // Keep a quarter of the window behind the current position so that going back to
+    // the previous video doesn't immediately require another window.
+    NSUInteger behind = MAX(length / 4, (NSUInteger)1);
+    if (self.loopMode == YTPlayerQueueLoopModeAll) {
+        return NSMakeRange((position + count - behind) % count, length);
+    }
+    NSUInteger location = (position >= behind) ? position - behind : 0;
+    if (location + length > count) {
+        location = count - length;
+    }
+    return NSMakeRange(location, length);
+}
+
+- (NSArray<NSString *> *)videoIdsInWindow:(NSRange)window {
+    NSUInteger count = self.count;
+    NSMutableArray *videoIds = [NSMutableArray arrayWithCapacity:window.length];
+    for (NSUInteger i = 0; i < window.length && count > 0; i++) {
+        [videoIds addObject:[self videoIdAtPosition:(window.location + i) % count]];
+    }
+    return videoIds;
+}
+
+- (NSUInteger)positionForIndex:(NSInteger)index inWindow:(NSRange)window {
+    if (index < 0 || (NSUInteger)index >= window.length || self.count == 0) {
+        return NSNotFound;
+    }
+    return (window.location + (NSUInteger)index) % self.count;
+}
+
+- (NSUInteger)indexForPosition:(NSUInteger)position inWindow:(NSRange)window {
+    NSUInteger count = self.count;
+    if (position >= count) {
+        return NSNotFound;
+    }
+    NSUInteger offset = (position + count - window.location % count) % count;
+    return (offset < window.length) ? offset : NSNotFound;
+}
+
+- (BOOL)window:(NSRange)window needsSlidingForPosition:(NSUInteger)position {
+    NSUInteger index = [self indexForPosition:position inWindow:window];
+    if (index == NSNotFound) {
+        return YES;
+    }
+    if (window.length >= self.count || self.loopMode == YTPlayerQueueLoopModeOne) {
+        // The iframe player already has everything it needs.
+        return NO;
+    }
+    BOOL wraps = (self.loopMode == YTPlayerQueueLoopModeAll);
+    BOOL hasMoreAfter = wraps || (window.location + window.length < self.count);
+    BOOL hasMoreBefore = wraps || (window.location > 0);
+    return (index + 1 == window.length && hasMoreAfter) || (index == 0 && hasMoreBefore);
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
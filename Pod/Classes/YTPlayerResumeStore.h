@@ -0,0 +1,94 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+#pragma mark - YTPlayerResumeStore
+
+
+/**
+ * YTPlayerResumeStore persists the playback position of each video, so that playback can be
+ * resumed where the user left off. It is designed to hold millions of videos.
+ *
+ * Positions are kept in two files inside the given directory:
+ *
+ * - `table`: an open addressing hash table of fixed size records keyed by video ID. It is
+ *   memory-mapped read-only, so opening the store doesn't read or parse it at all and every
+ *   lookup is O(1). Each record has a checksum, verified on lookup, so a record damaged on
+ *   disk reads as no position.
+ * - `journal`: an append-only log of the updates made since the table was written. Each record
+ *   has a checksum, so a record torn by a crash is simply discarded on the next open.
+ *
+ * Once the journal grows long enough it is compacted into a new table on a background queue,
+ * from a snapshot of the journal, while the old table keeps serving lookups. The new table is
+ * written to a temporary file and atomically renamed over the old one, then swapped in on the
+ * main queue, which only then drops the journal records it contains.
+ *
+ * Video IDs longer than 23 bytes in UTF-8 are not stored. YouTube video IDs are 11 characters.
+ * This class is not thread-safe. Use it from the main thread just like YTPlayerView.
+ */
+@interface YTPlayerResumeStore : NSObject
+
+/**
+ * Opens the store in the given directory, creating it if needed.
+ *
+ * @param path A path to the directory of the store.
+ * @param error On failure, an NSError object describing the problem.
+ * @return An opened store, or nil if the files could not be opened or are corrupted.
+ */
+- (nullable instancetype)initWithDirectoryPath:(NSString *)path error:(NSError * _Nullable * _Nullable)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/** The path to the directory of the store. */
+@property (nonatomic, copy, readonly) NSString *directoryPath;
+
+/**
+ * Returns the stored position of the given video in seconds, or 0 if there is none.
+ *
+ * @param videoId A YouTube video ID.
+ */
+- (float)positionForVideoId:(NSString *)videoId;
+
+/**
+ * Stores the position of the given video. The update is appended to the journal immediately.
+ *
+ * @param seconds The playback position in seconds.
+ * @param videoId A YouTube video ID.
+ */
+- (void)setPosition:(float)seconds forVideoId:(NSString *)videoId;
+
+/**
+ * Removes the stored position of the given video, e.g. because the user has finished it.
+ *
+ * @param videoId A YouTube video ID.
+ */
+- (void)removePositionForVideoId:(NSString *)videoId;
+
+/**
+ * Compacts the journal into a new table synchronously, superseding any background compaction.
+ * This is done automatically in the background as the journal grows, so you usually don't have
+ * to call this method yourself.
+ *
+ * @param error On failure, an NSError object describing the problem.
+ * @return YES if successful, NO if not. The store stays usable on failure.
+ */
+- (BOOL)compact:(NSError * _Nullable * _Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
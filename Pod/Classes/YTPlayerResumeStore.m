@@ -0,0 +1,585 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YTPlayerResumeStore.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// File names inside the store directory.
+NSString static * const YTPlayerResumeStoreTableFileName = @"table";
+NSString static * const YTPlayerResumeStoreTemporaryTableFileName = @"table.tmp";
+NSString static * const YTPlayerResumeStoreJournalFileName = @"journal";
+
+// Constants for the table file format.
+uint32_t static const YTPlayerResumeStoreMagic = 0x53525459; // "YTRS"
+uint32_t static const YTPlayerResumeStoreVersion = 1;
+uint64_t static const YTPlayerResumeStoreMinimumCapacity = 1024;
+
+// The journal is compacted once it has 1/16 as many records as the table, within these bounds.
+// This keeps compaction amortized O(1) per update while bounding the replay cost of opening the store.
+NSUInteger static const YTPlayerResumeStoreMinimumJournalLength = 4096;
+NSUInteger static const YTPlayerResumeStoreMaximumJournalLength = 65536;
+
+#define YTPlayerResumeStoreVideoIdLength 24
+
+// A record of both the table and the journal. Exactly 32 bytes.
+typedef struct {
+    char videoId[YTPlayerResumeStoreVideoIdLength];  // NUL-padded UTF-8. All zeros for unused slots.
+    float seconds;                                   // Negative for removed positions.
+    uint32_t checksum;
+} YTPlayerResumeRecord;
+
+// The header of the table file, followed by `capacity` records.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;  // Always a power of 2.
+    uint64_t count;     // The number of used slots, including removed positions.
+    uint64_t reserved;
+} YTPlayerResumeTableHeader;
+
+/**
+ * Private function to compute FNV-1a hash of the given bytes.
+ */
+static uint64_t YTPlayerResumeHash(const void *bytes, size_t length) {
+    const uint8_t *p = bytes;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * Private function to compute the checksum of a record. Never matches a record of all zeros.
+ */
+static uint32_t YTPlayerResumeChecksum(const YTPlayerResumeRecord *record) {
+    uint64_t hash = YTPlayerResumeHash(record, offsetof(YTPlayerResumeRecord, checksum));
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/**
+ * Private function to initialize a record with the given video ID.
+ *
+ * @return YES if successful, NO if the video ID is empty or too long to be stored.
+ */
+static BOOL YTPlayerResumeRecordInit(YTPlayerResumeRecord *record, NSString *videoId) {
+    memset(record, 0, sizeof(YTPlayerResumeRecord));
+    NSUInteger usedLength = 0;
+    NSRange remainingRange = NSMakeRange(0, 0);
+    BOOL converted = [videoId getBytes:record->videoId
+                             maxLength:YTPlayerResumeStoreVideoIdLength - 1
+                            usedLength:&usedLength
+                              encoding:NSUTF8StringEncoding
+                               options:0
+                                 range:NSMakeRange(0, videoId.length)
+                        remainingRange:&remainingRange];
+    return (converted && usedLength > 0 && remainingRange.length == 0);
+}
+
+/**
+ * Private function to find the slot for the given video ID in a table using linear probing.
+ *
+ * @return The slot holding the video ID, or the empty slot where it should be inserted.
+ */
+static YTPlayerResumeRecord *YTPlayerResumeTableProbe(YTPlayerResumeRecord *slots, uint64_t capacity, const char *videoId) {
+    uint64_t mask = capacity - 1;
+    uint64_t i = YTPlayerResumeHash(videoId, YTPlayerResumeStoreVideoIdLength) & mask;
+    while (slots[i].videoId[0] != 0 && memcmp(slots[i].videoId, videoId, YTPlayerResumeStoreVideoIdLength) != 0) {
+        i = (i + 1) & mask;
+    }
+    return &slots[i];
+}
+
+/**
+ * Private function to flush the entries of the given directory, e.g. a rename inside it, to permanent storage.
+ *
+ * @return YES if successful, NO if not.
+ */
+static BOOL YTPlayerResumeStoreSyncDirectory(NSString *path) {
+    int fd = open(path.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) {
+        return NO;
+    }
+    BOOL synced = (fsync(fd) == 0);
+    close(fd);
+    return synced;
+}
+
+/**
+ * Private function to return the first record of a mapped table.
+ */
+static YTPlayerResumeRecord *YTPlayerResumeTableSlots(const void *table) {
+    return (YTPlayerResumeRecord *)((char *)table + sizeof(YTPlayerResumeTableHeader));
+}
+
+/**
+ * Private function to create an NSError from the current errno.
+ *
+ * @return Always NO, for convenience.
+ */
+static BOOL YTPlayerResumeStoreSetPOSIXError(NSError * _Nullable * _Nullable error, NSString *path) {
+    if (error) {
+        *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+    }
+    return NO;
+}
+
+/**
+ * Private function to write a new table merging the given positions over an old table, and to rename it into place.
+ * It doesn't touch any state of YTPlayerResumeStore, so it can run on a background queue while the old table
+ * stays mapped for lookups.
+ *
+ * @param directoryPath The path to the directory of the store.
+ * @param oldTable The currently mapped table, or NULL if none.
+ * @param positions Positions to merge, including removed ones. These take precedence over the old table.
+ * @param error On failure, an NSError object describing the problem.
+ * @return YES if the new table has durably replaced the old file, NO if not.
+ */
+static BOOL YTPlayerResumeStoreWriteTable(NSString *directoryPath,
+                                          const void * _Nullable oldTable,
+                                          NSDictionary<NSString *, NSNumber *> *positions,
+                                          NSError * _Nullable * _Nullable error) {
+    const YTPlayerResumeTableHeader *oldHeader = oldTable;
+    uint64_t oldCapacity = (oldHeader != NULL) ? oldHeader->capacity : 0;
+    const YTPlayerResumeRecord *oldSlots = (oldHeader != NULL) ? YTPlayerResumeTableSlots(oldTable) : NULL;
+
+    // Keep the load factor of the new table at most 3/4, where linear probing still takes a couple of probes.
+    uint64_t expectedCount = ((oldHeader != NULL) ? oldHeader->count : 0) + positions.count;
+    uint64_t capacity = YTPlayerResumeStoreMinimumCapacity;
+    while (capacity * 3 < expectedCount * 4) {
+        capacity <<= 1;
+    }
+    size_t size = sizeof(YTPlayerResumeTableHeader) + (size_t)capacity * sizeof(YTPlayerResumeRecord);
+
+    NSString *tablePath = [directoryPath stringByAppendingPathComponent:YTPlayerResumeStoreTableFileName];
+    NSString *temporaryPath = [directoryPath stringByAppendingPathComponent:YTPlayerResumeStoreTemporaryTableFileName];
+    int fd = open(temporaryPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return YTPlayerResumeStoreSetPOSIXError(error, temporaryPath);
+    }
+    void *table = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        table = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (table == MAP_FAILED) {
+        YTPlayerResumeStoreSetPOSIXError(error, temporaryPath);
+        close(fd);
+        unlink(temporaryPath.fileSystemRepresentation);
+        return NO;
+    }
+
+    YTPlayerResumeTableHeader *header = table;
+    header->magic = YTPlayerResumeStoreMagic;
+    header->version = YTPlayerResumeStoreVersion;
+    header->capacity = capacity;
+    YTPlayerResumeRecord *slots = YTPlayerResumeTableSlots(table);
+    uint64_t count = 0;
+
+    // Journal positions go first so that they hide the same videos in the old table.
+    // Removed positions are written as well for that purpose, and dropped on the next compaction.
+    for (NSString *videoId in positions) {
+        YTPlayerResumeRecord record;
+        if (!YTPlayerResumeRecordInit(&record, videoId)) {
+            continue;
+        }
+        record.seconds = positions[videoId].floatValue;
+        record.checksum = YTPlayerResumeChecksum(&record);
+        *YTPlayerResumeTableProbe(slots, capacity, record.videoId) = record;
+        count++;
+    }
+    for (uint64_t i = 0; i < oldCapacity; i++) {
+        const YTPlayerResumeRecord *record = &oldSlots[i];
+        // Records damaged on disk are dropped rather than carried over.
+        if (record->videoId[0] == 0 || record->seconds < 0 || record->checksum != YTPlayerResumeChecksum(record)) {
+            continue;
+        }
+        YTPlayerResumeRecord *slot = YTPlayerResumeTableProbe(slots, capacity, record->videoId);
+        if (slot->videoId[0] == 0) {
+            *slot = *record;
+            count++;
+        }
+    }
+    header->count = count;
+
+    BOOL synced = (msync(table, size, MS_SYNC) == 0 && fsync(fd) == 0);
+    if (!synced) {
+        YTPlayerResumeStoreSetPOSIXError(error, temporaryPath);
+    }
+    munmap(table, size);
+    close(fd);
+    if (!synced || rename(temporaryPath.fileSystemRepresentation, tablePath.fileSystemRepresentation) != 0) {
+        if (synced) {
+            YTPlayerResumeStoreSetPOSIXError(error, tablePath);
+        }
+        unlink(temporaryPath.fileSystemRepresentation);
+        return NO;
+    }
+
+    // The new table is in place. Even if we crash from here on, replaying the journal onto it is harmless.
+    // The journal must not be shortened before the rename is durable, though, or a power loss could bring
+    // back the old table with an empty journal.
+    if (!YTPlayerResumeStoreSyncDirectory(directoryPath)) {
+        return YTPlayerResumeStoreSetPOSIXError(error, directoryPath);
+    }
+    return YES;
+}
+
+#pragma mark -
+
+
+@interface YTPlayerResumeStore()
+
+@property (nonatomic, copy) NSString *directoryPath;
+
+// Positions appended to the journal since the table was written. These override the table.
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *journalPositions;
+@property (nonatomic) NSUInteger journalLength;
+
+// Background compaction. `laterJournalPositions` holds the positions appended since the running compaction
+// took its snapshot of `journalPositions`, and is nil while no compaction is running.
+@property (nonatomic, strong) dispatch_queue_t compactionQueue;
+@property (nonatomic) NSUInteger compactionGeneration;
+@property (nonatomic, strong, nullable) NSMutableDictionary<NSString *, NSNumber *> *laterJournalPositions;
+
+@end
+
+@implementation YTPlayerResumeStore {
+    int _journalFileDescriptor;
+    void * _Nullable _table;
+    size_t _tableSize;
+}
+
+#pragma mark - Init/dealloc
+
+- (nullable instancetype)initWithDirectoryPath:(NSString *)path error:(NSError * _Nullable * _Nullable)error {
+    self = [super init];
+    if (self) {
+        _directoryPath = [path copy];
+        _journalPositions = [NSMutableDictionary dictionary];
+        _journalFileDescriptor = -1;
+        _compactionQueue = dispatch_queue_create("com.google.ytplayer.resumestore.compaction", DISPATCH_QUEUE_SERIAL);
+        if (![[NSFileManager defaultManager] createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:error]) {
+            return nil;
+        }
+        if (![self mapTable:&_table size:&_tableSize error:error] || ![self openJournal:error]) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self unmapTable];
+    if (_journalFileDescriptor >= 0) {
+        close(_journalFileDescriptor);
+    }
+}
+
+#pragma mark - Positions
+
+- (float)positionForVideoId:(NSString *)videoId {
+    NSNumber *journalPosition = self.journalPositions[videoId];
+    if (journalPosition != nil) {
+        return MAX(journalPosition.floatValue, 0.0f);
+    }
+    YTPlayerResumeRecord key;
+    if (_table == NULL || !YTPlayerResumeRecordInit(&key, videoId)) {
+        return 0.0f;
+    }
+    const YTPlayerResumeTableHeader *header = _table;
+    const YTPlayerResumeRecord *slot = YTPlayerResumeTableProbe(YTPlayerResumeTableSlots(_table), header->capacity, key.videoId);
+    // A record damaged on disk reads as no position rather than as a garbage one.
+    if (slot->videoId[0] == 0 || slot->checksum != YTPlayerResumeChecksum(slot)) {
+        return 0.0f;
+    }
+    return MAX(slot->seconds, 0.0f);
+}
+
+- (void)setPosition:(float)seconds forVideoId:(NSString *)videoId {
+    [self appendPosition:MAX(seconds, 0.0f) forVideoId:videoId];
+}
+
+- (void)removePositionForVideoId:(NSString *)videoId {
+    [self appendPosition:-1.0f forVideoId:videoId];
+}
+
+#pragma mark - Compaction
+
+- (BOOL)compact:(NSError * _Nullable * _Nullable)error {
+    // Let a running background compaction finish writing, then supersede it. Its pending swap becomes a no-op.
+    dispatch_sync(self.compactionQueue, ^{});
+    self.compactionGeneration++;
+    self.laterJournalPositions = nil;
+
+    if (![self canCompact:error] ||
+        !YTPlayerResumeStoreWriteTable(self.directoryPath, _table, self.journalPositions, error)) {
+        return NO;
+    }
+    return [self installTableReplacingJournalRecords:self.journalLength
+                                      laterPositions:[NSMutableDictionary dictionary]
+                                               error:error];
+}
+
+#pragma mark - Private methods
+
+- (BOOL)canCompact:(NSError * _Nullable * _Nullable)error {
+    NSString *tablePath = [self.directoryPath stringByAppendingPathComponent:YTPlayerResumeStoreTableFileName];
+    if (_table == NULL && access(tablePath.fileSystemRepresentation, F_OK) == 0) {
+        // A table we haven't mapped. Compacting the journal alone over it would lose every position it holds.
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteFileExistsError userInfo:@{NSFilePathErrorKey: tablePath}];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (void)compactInBackground {
+    if (self.laterJournalPositions != nil) {
+        // Already compacting.
+        return;
+    }
+    NSError *error = nil;
+    if (![self canCompact:&error]) {
+        NSLog(@"Received error while compacting YTPlayerResumeStore: %@", error);
+        return;
+    }
+
+    // Walking and writing a table of millions of records takes a while, so do it off the main thread from a
+    // snapshot. The old table stays mapped for lookups until the new one is swapped in on the main queue.
+    NSDictionary<NSString *, NSNumber *> *snapshot = [self.journalPositions copy];
+    NSUInteger snapshotLength = self.journalLength;
+    NSUInteger generation = ++self.compactionGeneration;
+    self.laterJournalPositions = [NSMutableDictionary dictionary];
+    const void *oldTable = _table;
+    NSString *directoryPath = self.directoryPath;
+    // The blocks retain self on purpose, so that the old table can't be unmapped while it is being read.
+    dispatch_async(self.compactionQueue, ^{
+        NSError *writeError = nil;
+        BOOL written = YTPlayerResumeStoreWriteTable(directoryPath, oldTable, snapshot, &writeError);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (self.compactionGeneration != generation) {
+                // Superseded by -compact:.
+                return;
+            }
+            NSMutableDictionary<NSString *, NSNumber *> *laterPositions = self.laterJournalPositions;
+            self.laterJournalPositions = nil;
+            NSError *installError = writeError;
+            if (!written || ![self installTableReplacingJournalRecords:snapshotLength laterPositions:laterPositions error:&installError]) {
+                NSLog(@"Received error while compacting YTPlayerResumeStore: %@", installError);
+            }
+        });
+    });
+}
+
+- (BOOL)installTableReplacingJournalRecords:(NSUInteger)replacedLength
+                             laterPositions:(NSMutableDictionary<NSString *, NSNumber *> *)laterPositions
+                                      error:(NSError * _Nullable * _Nullable)error {
+    /**
+     * Private method to swap in a table that has just been written, and drop the journal records it contains.
+     * On failure, the old mapping and the whole journal are kept, which together still hold every position.
+     *
+     * @param replacedLength The number of leading journal records merged into the new table.
+     * @param laterPositions The positions of the journal records after those.
+     */
+    void *newTable = NULL;
+    size_t newTableSize = 0;
+    if (![self mapTable:&newTable size:&newTableSize error:error]) {
+        return NO;
+    }
+    if (![self dropJournalRecords:replacedLength error:error]) {
+        if (newTable != NULL) {
+            munmap(newTable, newTableSize);
+        }
+        return NO;
+    }
+    [self unmapTable];
+    _table = newTable;
+    _tableSize = newTableSize;
+    self.journalPositions = laterPositions;
+    return YES;
+}
+
+- (BOOL)dropJournalRecords:(NSUInteger)count error:(NSError * _Nullable * _Nullable)error {
+    NSString *journalPath = [self.directoryPath stringByAppendingPathComponent:YTPlayerResumeStoreJournalFileName];
+    if (count >= self.journalLength) {
+        if (ftruncate(_journalFileDescriptor, 0) != 0 || fsync(_journalFileDescriptor) != 0) {
+            return YTPlayerResumeStoreSetPOSIXError(error, journalPath);
+        }
+        self.journalLength = 0;
+        return YES;
+    }
+
+    // Records have been appended while compacting in the background. Keep only those, replacing the journal
+    // atomically so that a crash leaves either the whole old journal or the new one.
+    size_t offset = count * sizeof(YTPlayerResumeRecord);
+    size_t length = (self.journalLength - count) * sizeof(YTPlayerResumeRecord);
+    NSMutableData *tail = [NSMutableData dataWithLength:length];
+    if (pread(_journalFileDescriptor, tail.mutableBytes, length, (off_t)offset) != (ssize_t)length) {
+        return YTPlayerResumeStoreSetPOSIXError(error, journalPath);
+    }
+    NSString *temporaryPath = [journalPath stringByAppendingPathExtension:@"tmp"];
+    int fd = open(temporaryPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0) {
+        return YTPlayerResumeStoreSetPOSIXError(error, temporaryPath);
+    }
+    if (write(fd, tail.bytes, length) != (ssize_t)length || fsync(fd) != 0 ||
+        rename(temporaryPath.fileSystemRepresentation, journalPath.fileSystemRepresentation) != 0) {
+        YTPlayerResumeStoreSetPOSIXError(error, temporaryPath);
+        close(fd);
+        unlink(temporaryPath.fileSystemRepresentation);
+        return NO;
+    }
+    YTPlayerResumeStoreSyncDirectory(self.directoryPath);
+    close(_journalFileDescriptor);
+    _journalFileDescriptor = fd;
+    self.journalLength -= count;
+    return YES;
+}
+
+- (BOOL)mapTable:(void * _Nullable * _Nonnull)outTable size:(size_t *)outSize error:(NSError * _Nullable * _Nullable)error {
+    /**
+     * Private method to map the table file read-only.
+     *
+     * @param outTable On success, the mapped table, or NULL if no table has been written yet.
+     * @param outSize On success, the size of the mapping.
+     */
+    *outTable = NULL;
+    *outSize = 0;
+    NSString *tablePath = [self.directoryPath stringByAppendingPathComponent:YTPlayerResumeStoreTableFileName];
+    int fd = open(tablePath.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) {
+        // No table has been written yet.
+        return (errno == ENOENT) ? YES : YTPlayerResumeStoreSetPOSIXError(error, tablePath);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        YTPlayerResumeStoreSetPOSIXError(error, tablePath);
+        close(fd);
+        return NO;
+    }
+    size_t size = (size_t)st.st_size;
+    void *table = MAP_FAILED;
+    if (size >= sizeof(YTPlayerResumeTableHeader)) {
+        table = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (table == MAP_FAILED) {
+            YTPlayerResumeStoreSetPOSIXError(error, tablePath);
+            close(fd);
+            return NO;
+        }
+    }
+    close(fd);
+
+    const YTPlayerResumeTableHeader *header = (table != MAP_FAILED) ? table : NULL;
+    BOOL valid = (header != NULL &&
+                  header->magic == YTPlayerResumeStoreMagic &&
+                  header->version == YTPlayerResumeStoreVersion &&
+                  header->capacity > 0 && (header->capacity & (header->capacity - 1)) == 0 &&
+                  header->count < header->capacity &&
+                  size == sizeof(YTPlayerResumeTableHeader) + header->capacity * sizeof(YTPlayerResumeRecord));
+    if (!valid) {
+        if (table != MAP_FAILED) {
+            munmap(table, size);
+        }
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:@{NSFilePathErrorKey: tablePath}];
+        }
+        return NO;
+    }
+    *outTable = table;
+    *outSize = size;
+    return YES;
+}
+
+- (void)unmapTable {
+    if (_table != NULL) {
+        munmap(_table, _tableSize);
+        _table = NULL;
+        _tableSize = 0;
+    }
+}
+
+- (BOOL)openJournal:(NSError * _Nullable * _Nullable)error {
+    NSString *journalPath = [self.directoryPath stringByAppendingPathComponent:YTPlayerResumeStoreJournalFileName];
+    int fd = open(journalPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return YTPlayerResumeStoreSetPOSIXError(error, journalPath);
+    }
+    NSData *journal = [NSData dataWithContentsOfFile:journalPath options:0 error:error];
+    if (journal == nil) {
+        close(fd);
+        return NO;
+    }
+
+    const YTPlayerResumeRecord *records = journal.bytes;
+    NSUInteger recordCount = journal.length / sizeof(YTPlayerResumeRecord);
+    NSUInteger validCount = 0;
+    for (; validCount < recordCount; validCount++) {
+        const YTPlayerResumeRecord *record = &records[validCount];
+        if (record->checksum != YTPlayerResumeChecksum(record) || record->videoId[YTPlayerResumeStoreVideoIdLength - 1] != 0) {
+            break;
+        }
+        NSString *videoId = [[NSString alloc] initWithUTF8String:record->videoId];
+        if (videoId == nil) {
+            break;
+        }
+        self.journalPositions[videoId] = @(record->seconds);
+    }
+    if (validCount * sizeof(YTPlayerResumeRecord) != journal.length) {
+        // The tail has been torn by a crash. Discard it so that following records stay aligned.
+        if (ftruncate(fd, (off_t)(validCount * sizeof(YTPlayerResumeRecord))) != 0) {
+            YTPlayerResumeStoreSetPOSIXError(error, journalPath);
+            close(fd);
+            return NO;
+        }
+    }
+    _journalFileDescriptor = fd;
+    self.journalLength = validCount;
+    return YES;
+}
+
+- (void)appendPosition:(float)seconds forVideoId:(NSString *)videoId {
+    YTPlayerResumeRecord record;
+    if (!YTPlayerResumeRecordInit(&record, videoId)) {
+        NSLog(@"YTPlayerResumeStore can't store the position of the video ID: %@", videoId);
+        return;
+    }
+    record.seconds = seconds;
+    record.checksum = YTPlayerResumeChecksum(&record);
+
+    self.journalPositions[videoId] = @(seconds);
+    self.laterJournalPositions[videoId] = @(seconds);
+    if (write(_journalFileDescriptor, &record, sizeof(record)) != sizeof(record)) {
+        NSLog(@"Received error while appending to YTPlayerResumeStore journal: %s", strerror(errno));
+    }
+    self.journalLength++;
+
+    const YTPlayerResumeTableHeader *header = _table;
+    NSUInteger tableCount = (header != NULL) ? (NSUInteger)header->count : 0;
+    NSUInteger limit = MIN(MAX(tableCount / 16, YTPlayerResumeStoreMinimumJournalLength), YTPlayerResumeStoreMaximumJournalLength);
+    if (self.journalLength >= limit) {
+        [self compactInBackground];
+    }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
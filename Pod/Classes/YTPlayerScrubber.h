@@ -0,0 +1,88 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^YTPlayerScrubberSeekCompletion)(NSError * _Nullable error);
+typedef void (^YTPlayerScrubberSeekHandler)(float seconds, BOOL allowSeekAhead, YTPlayerScrubberSeekCompletion completion);
+
+
+#pragma mark - YTPlayerScrubber
+
+
+/**
+ * YTPlayerScrubber coalesces the flood of seek requests produced while the user drags a scrubber.
+ *
+ * During a scrubbing session at most one seek is in flight at a time, and seeks are dispatched
+ * no more often than `minimumSeekInterval`. Positions reported while a seek is in flight or
+ * throttled are dropped except for the latest one. Intermediate seeks are dispatched with
+ * `allowSeekAhead` NO so they never hit the network, and ending the session dispatches exactly
+ * one final seek with `allowSeekAhead` YES.
+ *
+ * Seeks are performed by the given seek handler, which makes this class testable headlessly.
+ * All methods must be called on the main thread, and the seek handler must call its completion
+ * on the main thread as well.
+ */
+@interface YTPlayerScrubber : NSObject
+
+/**
+ * Initializes a new scrubber.
+ *
+ * @param seekHandler A block that performs a seek and calls the given completion once it's done.
+ */
+- (instancetype)initWithSeekHandler:(YTPlayerScrubberSeekHandler)seekHandler NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * The minimum interval in seconds between two intermediate seeks.
+ * Default value is 1/30, i.e. at most one seek every other frame on a 60Hz display.
+ */
+@property (nonatomic) NSTimeInterval minimumSeekInterval;
+
+/** A Boolean value indicating whether a session is active, including its final seek. */
+@property (nonatomic, readonly, getter=isScrubbing) BOOL scrubbing;
+
+/** The latest position given by `-updateToSeconds:` in the current or last session. */
+@property (nonatomic, readonly) float previewSeconds;
+
+/** The number of seeks dispatched to the seek handler so far, including final seeks. */
+@property (nonatomic, readonly) NSUInteger dispatchedSeekCount;
+
+/**
+ * Begins a new scrubbing session. If the final seek of the previous session is not dispatched
+ * yet, it is superseded and its completion is called with no error.
+ */
+- (void)begin;
+
+/**
+ * Reports a new scrubbing position. Does nothing unless a session has begun and not ended yet.
+ *
+ * @param seconds The time in seconds to seek to.
+ */
+- (void)updateToSeconds:(float)seconds;
+
+/**
+ * Ends the current session, dispatching the final seek to `previewSeconds` once any seek in
+ * flight has completed.
+ *
+ * @param completion A block called once the final seek has completed.
+ */
+- (void)endWithCompletion:(nullable YTPlayerScrubberSeekCompletion)completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
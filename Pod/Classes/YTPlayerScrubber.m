@@ -0,0 +1,152 @@
+// Copyright 2014 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YTPlayerScrubber.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Default minimum interval between two intermediate seeks.
+NSTimeInterval static const YTPlayerScrubberDefaultMinimumSeekInterval = 1.0 / 30.0;
+
+#pragma mark -
+
+
+@interface YTPlayerScrubber()
+
+@property (nonatomic, copy) YTPlayerScrubberSeekHandler seekHandler;
+@property (nonatomic) BOOL scrubbing;
+@property (nonatomic) float previewSeconds;
+@property (nonatomic) NSUInteger dispatchedSeekCount;
+
+@property (nonatomic) BOOL hasPendingSeek;
+@property (nonatomic) BOOL seekInFlight;
+@property (nonatomic) BOOL seekScheduled;
+@property (nonatomic) NSTimeInterval lastSeekTime;
+@property (nonatomic) BOOL ending;
+@property (nonatomic) NSUInteger session;
+@property (nonatomic, copy, nullable) YTPlayerScrubberSeekCompletion endCompletion;
+
+@end
+
+@implementation YTPlayerScrubber
+
+#pragma mark - Init/dealloc
+
+- (instancetype)initWithSeekHandler:(YTPlayerScrubberSeekHandler)seekHandler {
+    self = [super init];
+    if (self) {
+        _seekHandler = [seekHandler copy];
+        _minimumSeekInterval = YTPlayerScrubberDefaultMinimumSeekInterval;
+        _lastSeekTime = -DBL_MAX;
+    }
+    return self;
+}
+
+#pragma mark - Scrubbing session
+
+- (void)begin {
+    if (self.ending) {
+        YTPlayerScrubberSeekCompletion completion = self.endCompletion;
+        self.endCompletion = nil;
+        self.ending = NO;
+        if (completion) {
+            completion(nil);
+        }
+    }
+    self.session++;
+    self.scrubbing = YES;
+    self.hasPendingSeek = NO;
+}
+
+- (void)updateToSeconds:(float)seconds {
+    if (!self.scrubbing || self.ending) {
+        return;
+    }
+    self.previewSeconds = seconds;
+    self.hasPendingSeek = YES;
+    [self dispatchPendingSeek];
+}
+
+- (void)endWithCompletion:(nullable YTPlayerScrubberSeekCompletion)completion {
+    if (!self.scrubbing || self.ending) {
+        if (completion) {
+            completion(nil);
+        }
+        return;
+    }
+    self.ending = YES;
+    self.endCompletion = completion;
+    // Always seek again even if the latest position has already been dispatched,
+    // because that seek was made without allowSeekAhead.
+    self.hasPendingSeek = YES;
+    [self dispatchPendingSeek];
+}
+
+#pragma mark - Private methods
+
+- (void)dispatchPendingSeek {
+    if (!self.hasPendingSeek || self.seekInFlight) {
+        return;
+    }
+
+    __weak typeof(self) weakSelf = self;
+    if (self.ending) {
+        // The final seek is never throttled.
+        YTPlayerScrubberSeekCompletion completion = self.endCompletion;
+        self.endCompletion = nil;
+        self.ending = NO;
+        self.hasPendingSeek = NO;
+        self.seekInFlight = YES;
+        self.dispatchedSeekCount++;
+        NSUInteger session = self.session;
+        self.seekHandler(self.previewSeconds, YES, ^(NSError * _Nullable error) {
+            weakSelf.seekInFlight = NO;
+            if (weakSelf.session == session) {
+                weakSelf.scrubbing = NO;
+            }
+            if (completion) {
+                completion(error);
+            }
+            [weakSelf dispatchPendingSeek];
+        });
+        return;
+    }
+
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    NSTimeInterval elapsed = now - self.lastSeekTime;
+    if (elapsed < self.minimumSeekInterval) {
+        if (!self.seekScheduled) {
+            self.seekScheduled = YES;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((self.minimumSeekInterval - elapsed) * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+                weakSelf.seekScheduled = NO;
+                [weakSelf dispatchPendingSeek];
+            });
+        }
+        return;
+    }
+
+    self.hasPendingSeek = NO;
+    self.seekInFlight = YES;
+    self.lastSeekTime = now;
+    self.dispatchedSeekCount++;
+    self.seekHandler(self.previewSeconds, NO, ^(NSError * _Nullable error) {
+        // Errors of intermediate seeks don't matter, the final seek will report its own.
+        weakSelf.seekInFlight = NO;
+        [weakSelf dispatchPendingSeek];
+    });
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
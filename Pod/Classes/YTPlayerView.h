@@ -14,10 +14,14 @@
 
 #import <UIKit/UIKit.h>
 #import <WebKit/WebKit.h>
+#import "YTPlayerQueue.h"
+#import "YTPlayerResumeStore.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @class YTPlayerView;
+@class YTPlayerQualityController;
+@class YTPlayerQualityDecision;
 
 
 #pragma mark - Enums/Constants definitions
@@ -123,6 +127,15 @@ typedef void (^YTPlayerViewJSResultStringArray)(NSArray<NSString *> * _Nullable
  */
 - (void)playerView:(YTPlayerView *)playerView didPlayTime:(float)playTime;
 
+/**
+ * Callback invoked when `qualityController` has decided to change the playback quality.
+ * The new quality has already been suggested to the player when this is called.
+ *
+ * @param playerView The YTPlayerView instance where playback quality is being adapted.
+ * @param decision A YTPlayerQualityDecision describing the change and its reason.
+ */
+- (void)playerView:(YTPlayerView *)playerView didAdaptPlaybackQuality:(YTPlayerQualityDecision *)decision;
+
 @end
 
 
@@ -189,6 +202,36 @@ typedef void (^YTPlayerViewJSResultStringArray)(NSArray<NSString *> * _Nullable
  */
 @property (nonatomic, strong, nullable) UIView *initialLoadingView;
 
+/**
+ A store to persist playback positions to, so that each video resumes where the user left off.
+
+ While set, the position of the current video is saved periodically while playing and immediately when paused,
+ and removed once the video has ended. The saved position is used as the start time by
+ `-loadPlayerWithVideoId:playerVars:` unless `start` is given in playerVars, and by the `-cueVideoById:` and
+ `-loadVideoById:` family of methods when `startSeconds` is 0. Positions are saved only once the player has
+ confirmed which video is playing, which covers videos loaded by URL or reached through a playlist too.
+
+ Default value is nil, which doesn't save anything.
+ */
+@property (nonatomic, strong, nullable) YTPlayerResumeStore *resumeStore;
+
+/**
+ * The minimum interval in seconds between two saves of the playback position to `resumeStore` while playing.
+ * Default value is 5.
+ */
+@property (nonatomic) NSTimeInterval resumePositionSaveInterval;
+
+/**
+ A controller to adapt playback quality to the network automatically.
+
+ While set, YTPlayerView feeds it buffering state changes, seeks and samples of `videoLoadedFraction`, and suggests
+ the quality it decides with `-setPlaybackQuality:callback:`. Decisions are reported to the delegate by
+ `-playerView:didAdaptPlaybackQuality:`. Import YTPlayerQualityController.h to create one.
+
+ Default value is nil, which leaves playback quality to the player.
+ */
+@property (nonatomic, strong, nullable) YTPlayerQualityController *qualityController;
+
 #pragma mark - Initial loading methods
 
 /**
@@ -319,6 +362,42 @@ typedef void (^YTPlayerViewJSResultStringArray)(NSArray<NSString *> * _Nullable
  */
 - (void)seekToSeconds:(float)seekToSeconds allowSeekAhead:(BOOL)allowSeekAhead callback:(nullable YTPlayerViewJSResultVoid)callback;
 
+#pragma mark - Scrubbing
+
+// Use these methods instead of YTPlayerView::seekToSeconds:allowSeekAhead:callback: while the user
+// drags a custom scrubber. Seeks are coalesced so that at most one is in flight at a time, and
+// only the final one is allowed to make a new request to the server.
+
+/**
+ * The minimum interval in seconds between two seeks while scrubbing.
+ * Default value is 1/30.
+ */
+@property (nonatomic) NSTimeInterval scrubbingSeekInterval;
+
+/** A Boolean value indicating whether a scrubbing session is active, including its final seek. */
+@property (nonatomic, readonly, getter=isScrubbing) BOOL scrubbing;
+
+/**
+ * Begins a scrubbing session. While scrubbing, `-playerView:didPlayTime:` reports the scrubbing
+ * position instead of the time reported by the player.
+ */
+- (void)beginScrubbing;
+
+/**
+ * Moves the scrubbing position. The delegate is notified of the new position immediately by
+ * `-playerView:didPlayTime:`, while the actual seek may be dropped or delayed.
+ *
+ * @param seconds The time in seconds to seek to in the loaded video.
+ */
+- (void)scrubToSeconds:(float)seconds;
+
+/**
+ * Ends the scrubbing session with a final seek to the last scrubbing position with `allowSeekAhead` YES.
+ *
+ * @param callback A block called once the final seek has completed.
+ */
+- (void)endScrubbing:(nullable YTPlayerViewJSResultVoid)callback;
+
 #pragma mark - Queuing videos
 
 // Queueing functions for videos. These methods correspond to their JavaScript
@@ -651,6 +730,9 @@ typedef void (^YTPlayerViewJSResultStringArray)(NSArray<NSString *> * _Nullable
  * to the JavaScript API defined here:
  *   https://developers.google.com/youtube/iframe_api_reference#getPlaylist
  *
+ * While playing a YTPlayerQueue this only returns the window loaded into the iframe player.
+ * Use `videoQueue` to access the whole queue natively.
+ *
  * @return An NSArray containing all the video IDs in the current playlist. |nil| on error.
  */
 - (void)playlist:(nullable YTPlayerViewJSResultStringArray)callback;
@@ -664,6 +746,74 @@ typedef void (^YTPlayerViewJSResultStringArray)(NSArray<NSString *> * _Nullable
  */
 - (void)playlistIndex:(nullable YTPlayerViewJSResultInteger)callback;
 
+#pragma mark - Native video queue
+
+// These methods play a YTPlayerQueue, which is kept natively instead of in the iframe player.
+// Only a window of the queue around the current position is passed to the iframe player
+// using the JavaScript API below, and the window is slid automatically as playback moves on:
+//   https://developers.google.com/youtube/iframe_api_reference#loadPlaylist
+
+/**
+ * The queue currently being played, or nil if none. Set by the methods below, and cleared when
+ * anything else is cued or loaded, or when the playlist methods above are used.
+ * Shuffling, unshuffling or changing `loopMode` of the queue while it is being played reloads
+ * the window around the current video, so that the iframe player follows the new play order.
+ */
+@property (nonatomic, strong, nullable, readonly) YTPlayerQueue *videoQueue;
+
+/**
+ * Loads and plays the given queue from its current position. The queue's video IDs are
+ * passed to the iframe player with `player.loadPlaylist()` a window at a time.
+ * The player must have been loaded with one of the *Initial loading methods* before.
+ *
+ * @param queue A queue to play. It is retained as `videoQueue`.
+ * @param startSeconds Time in seconds to start the current video when it has loaded.
+ * @param suggestedQuality YTPlaybackQuality value suggesting a playback quality.
+ */
+- (void)loadVideoQueue:(YTPlayerQueue *)queue
+          startSeconds:(float)startSeconds
+      suggestedQuality:(YTPlaybackQuality)suggestedQuality
+              callback:(nullable YTPlayerViewJSResultVoid)callback;
+
+/**
+ * Cues the given queue at its current position without starting playback. The queue's video
+ * IDs are passed to the iframe player with `player.cuePlaylist()` a window at a time.
+ *
+ * @param queue A queue to cue. It is retained as `videoQueue`.
+ * @param startSeconds Time in seconds to start the current video when YTPlayerView::playVideo is called.
+ * @param suggestedQuality YTPlaybackQuality value suggesting a playback quality.
+ */
+- (void)cueVideoQueue:(YTPlayerQueue *)queue
+         startSeconds:(float)startSeconds
+     suggestedQuality:(YTPlaybackQuality)suggestedQuality
+             callback:(nullable YTPlayerViewJSResultVoid)callback;
+
+/**
+ * Loads and plays the next video of `videoQueue`, honoring its loop mode.
+ * Fails with YTPlayerErrorInvalidParam if there is no next video.
+ */
+- (void)nextVideoInQueue:(nullable YTPlayerViewJSResultVoid)callback;
+
+/**
+ * Loads and plays the previous video of `videoQueue`, honoring its loop mode.
+ * Fails with YTPlayerErrorInvalidParam if there is no previous video.
+ */
+- (void)previousVideoInQueue:(nullable YTPlayerViewJSResultVoid)callback;
+
+/**
+ * Loads and plays the video at the given position in the play order of `videoQueue`.
+ *
+ * @param position The 0-indexed position in the play order of `videoQueue`.
+ */
+- (void)playVideoInQueueAtPosition:(NSUInteger)position callback:(nullable YTPlayerViewJSResultVoid)callback;
+
+/**
+ * Returns the position of the currently playing video in the play order of `videoQueue`,
+ * which is `player.getPlaylistIndex()` mapped back from the loaded window.
+ * Also updates `videoQueue.currentPosition` to the returned value.
+ */
+- (void)videoQueuePosition:(nullable YTPlayerViewJSResultInteger)callback;
+
 #pragma mark - Exposed for Testing
 
 /**
@@ -672,6 +822,14 @@ typedef void (^YTPlayerViewJSResultStringArray)(NSArray<NSString *> * _Nullable
  */
 - (void)removeWebView;
 
+/**
+ * An HTML template to load instead of the bundled iframe player template, e.g. a stub page without any
+ * external script. It must contain a single `%@`, which is replaced with the player parameters in JSON.
+ * Default value is nil, which loads the bundled template.
+ * Intended to use for testing, should not be used in production code.
+ */
+@property (nonatomic, copy, nullable) NSString *embedHTMLTemplate;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #import "YTPlayerView.h"
+#import "YTPlayerScrubber.h"
+#import "YTPlayerQualityController.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -59,6 +61,16 @@ NSString static * const YTPlayerCallbackOnPlayTime = @"onPlayTime";
 NSString static * const YTPlayerCallbackOnYouTubeIframeAPIReady = @"onYouTubeIframeAPIReady";
 NSString static * const YTPlayerCallbackOnYouTubeIframeAPIFailedToLoad = @"onYouTubeIframeAPIFailedToLoad";
 
+// Constants representing script message handler names.
+NSString static * const YTPlayerScriptMessageLog = @"log";
+NSString static * const YTPlayerScriptMessageCallback = @"callback";
+
+// Context for observing the play order and loop mode of `videoQueue`.
+static void *YTPlayerViewVideoQueueObservationContext = &YTPlayerViewVideoQueueObservationContext;
+
+// Interval between re-evaluations of the quality controller while playback is stalled.
+NSTimeInterval static const YTPlayerQualityStallCheckInterval = 1.0;
+
 // Constants for regex patterns.
 NSString static * const YTPlayerEmbedUrlRegexPattern = @"^http(s)://(www.)youtube.com/embed/(.*)$";
 NSString static * const YTPlayerAdUrlRegexPattern = @"^http(s)://pubads.g.doubleclick.net/pagead/conversion/";
@@ -133,6 +145,38 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 #pragma mark -
 
 
+/**
+ * A script message handler that forwards messages to another handler without retaining it.
+ * WKUserContentController retains its handlers strongly, so registering YTPlayerView directly would
+ * make a retain cycle through its web view and leak both of them along with the Web Content memory.
+ */
+@interface YTPlayerWeakScriptMessageHandler : NSObject <WKScriptMessageHandler>
+
+@property (nonatomic, weak, nullable) id<WKScriptMessageHandler> handler;
+
+- (instancetype)initWithHandler:(id<WKScriptMessageHandler>)handler;
+
+@end
+
+@implementation YTPlayerWeakScriptMessageHandler
+
+- (instancetype)initWithHandler:(id<WKScriptMessageHandler>)handler {
+    self = [super init];
+    if (self) {
+        _handler = handler;
+    }
+    return self;
+}
+
+- (void)userContentController:(WKUserContentController *)userContentController didReceiveScriptMessage:(WKScriptMessage *)message {
+    [self.handler userContentController:userContentController didReceiveScriptMessage:message];
+}
+
+@end
+
+#pragma mark -
+
+
 @interface YTPlayerView() <WKNavigationDelegate, WKUIDelegate, WKScriptMessageHandler>
 
 @property (nonatomic, strong, nullable) WKWebView *webView;
@@ -141,6 +185,21 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 @property (nonatomic, strong, nullable) WKNavigation *htmlLoadingNavigation;
 @property (nonatomic) YTPlayerState playerState;
 
+@property (nonatomic, strong, nullable) YTPlayerQueue *videoQueue;
+@property (nonatomic) NSRange videoQueueWindow;
+@property (nonatomic) YTPlaybackQuality videoQueueQuality;
+@property (nonatomic) BOOL videoQueueReloadScheduled;
+
+@property (nonatomic, strong) YTPlayerScrubber *scrubber;
+
+@property (nonatomic, copy, nullable) NSString *currentVideoId;
+@property (nonatomic) NSUInteger currentVideoIdGeneration;
+@property (nonatomic) float lastPlayTime;
+@property (nonatomic) NSTimeInterval lastResumePositionSaveTime;
+
+@property (nonatomic) NSTimeInterval lastBufferSampleTime;
+@property (nonatomic) NSUInteger qualityStallCheckGeneration;
+
 @end
 
 @implementation YTPlayerView
@@ -163,9 +222,24 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     return self;
 }
 
+- (void)dealloc {
+    [self removeWebView];
+}
+
 - (void)commonInitialize {
     self.playerState = YTPlayerStateUnknown;
     self.allowsInlineMediaPlayback = YES;
+    self.resumePositionSaveInterval = 5.0;
+    
+    __weak typeof(self) weakSelf = self;
+    self.scrubber = [[YTPlayerScrubber alloc] initWithSeekHandler:^(float seconds, BOOL allowSeekAhead, YTPlayerScrubberSeekCompletion completion) {
+        typeof(self) strongSelf = weakSelf;
+        if (strongSelf == nil) {
+            completion(nil);
+            return;
+        }
+        [strongSelf seekToSeconds:seconds allowSeekAhead:allowSeekAhead callback:completion];
+    }];
 }
 
 #pragma mark - Initial configuration properties
@@ -206,6 +280,12 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     if (playerVars == nil) {
         playerVars = @{};
     }
+    float resumeSeconds = [self startSecondsForVideoId:videoId startSeconds:0];
+    if (playerVars[@"start"] == nil && resumeSeconds > 0) {
+        NSMutableDictionary *tempPlayerVars = [playerVars mutableCopy];
+        tempPlayerVars[@"start"] = @((NSInteger)resumeSeconds);
+        playerVars = tempPlayerVars;
+    }
     NSDictionary *playerParams = @{@"videoId": videoId, @"playerVars": playerVars};
     return [self loadPlayerWithPlayerParams:playerParams];
 }
@@ -219,6 +299,7 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 }
 
 - (BOOL)loadPlayerWithPlayerParams:(nullable NSDictionary *)additionalPlayerParams {
+    [self invalidateCurrentVideoId];
     NSMutableDictionary *playerParams = (additionalPlayerParams == nil) ? [NSMutableDictionary dictionary] : [additionalPlayerParams mutableCopy];
     if (playerParams[@"height"] == nil) {
         playerParams[@"height"] = @"100%";
@@ -256,24 +337,27 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     [self addConstraints:[NSLayoutConstraint constraintsWithVisualFormat:@"H:|[view]|" options:0 metrics:nil views:@{@"view": self.webView}]];
     [self addConstraints:[NSLayoutConstraint constraintsWithVisualFormat:@"V:|[view]|" options:0 metrics:nil views:@{@"view": self.webView}]];
     
-    NSString *htmlPath = [[NSBundle bundleForClass:[self class]] pathForResource:@"YTPlayerView-iframe-player"
-                                                                          ofType:@"html"
-                                                                     inDirectory:@"Assets"];
-    
-    // In case of using Swift and embedded frameworks, resources included not in main bundle, but in framework bundle.
-    if (htmlPath == nil) {
-        htmlPath = [[[self class] frameworkBundle] pathForResource:@"YTPlayerView-iframe-player"
-                                                            ofType:@"html"
-                                                       inDirectory:@"Assets"];
-    }
-    
-    NSError *htmlError = nil;
-    NSString *embedHTMLTemplate = [NSString stringWithContentsOfFile:htmlPath
-                                                            encoding:NSUTF8StringEncoding
-                                                               error:&htmlError];
-    if (htmlError) {
-        NSLog(@"Received error while reading YTPlayerView HTML template: %@", htmlError);
-        return NO;
+    NSString *embedHTMLTemplate = self.embedHTMLTemplate;
+    if (embedHTMLTemplate == nil) {
+        NSString *htmlPath = [[NSBundle bundleForClass:[self class]] pathForResource:@"YTPlayerView-iframe-player"
+                                                                              ofType:@"html"
+                                                                         inDirectory:@"Assets"];
+        
+        // In case of using Swift and embedded frameworks, resources included not in main bundle, but in framework bundle.
+        if (htmlPath == nil) {
+            htmlPath = [[[self class] frameworkBundle] pathForResource:@"YTPlayerView-iframe-player"
+                                                                ofType:@"html"
+                                                           inDirectory:@"Assets"];
+        }
+        
+        NSError *htmlError = nil;
+        embedHTMLTemplate = [NSString stringWithContentsOfFile:htmlPath
+                                                      encoding:NSUTF8StringEncoding
+                                                         error:&htmlError];
+        if (htmlError) {
+            NSLog(@"Received error while reading YTPlayerView HTML template: %@", htmlError);
+            return NO;
+        }
     }
     
     NSError *jsonError = nil;
@@ -332,6 +416,7 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     NSNumber *secondsValue = [NSNumber numberWithFloat:seekToSeconds];
     NSString *allowSeekAheadValue = NSStringFromYTPlayerJSBoolean(allowSeekAhead);
     NSString *command = [NSString stringWithFormat:@"player.seekTo(%@, %@);", secondsValue, allowSeekAheadValue];
+    [self.qualityController playerDidSeekAtTime:[NSProcessInfo processInfo].systemUptime];
     [self evaluateJavaScript:command completionHandler:^(id _Nullable result, NSError * _Nullable error) {
         if (callback) {
             callback(error);
@@ -339,12 +424,43 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     }];
 }
 
+#pragma mark - Scrubbing
+
+- (NSTimeInterval)scrubbingSeekInterval {
+    return self.scrubber.minimumSeekInterval;
+}
+
+- (void)setScrubbingSeekInterval:(NSTimeInterval)scrubbingSeekInterval {
+    self.scrubber.minimumSeekInterval = scrubbingSeekInterval;
+}
+
+- (BOOL)isScrubbing {
+    return self.scrubber.isScrubbing;
+}
+
+- (void)beginScrubbing {
+    [self.scrubber begin];
+}
+
+- (void)scrubToSeconds:(float)seconds {
+    [self.scrubber updateToSeconds:seconds];
+    if (self.scrubber.isScrubbing && [self.delegate respondsToSelector:@selector(playerView:didPlayTime:)]) {
+        [self.delegate playerView:self didPlayTime:self.scrubber.previewSeconds];
+    }
+}
+
+- (void)endScrubbing:(nullable YTPlayerViewJSResultVoid)callback {
+    [self.scrubber endWithCompletion:callback];
+}
+
 #pragma mark - Queuing videos
 
 - (void)cueVideoById:(NSString *)videoId
         startSeconds:(float)startSeconds
     suggestedQuality:(YTPlaybackQuality)suggestedQuality
             callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    startSeconds = [self startSecondsForVideoId:videoId startSeconds:startSeconds];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
     NSString *command = [NSString stringWithFormat:@"player.cueVideoById('%@', %@, '%@');", videoId, startSecondsValue, qualityValue];
@@ -360,6 +476,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
           endSeconds:(float)endSeconds
     suggestedQuality:(YTPlaybackQuality)suggestedQuality
             callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    startSeconds = [self startSecondsForVideoId:videoId startSeconds:startSeconds];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSNumber *endSecondsValue = [NSNumber numberWithFloat:endSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
@@ -375,6 +493,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
          startSeconds:(float)startSeconds
      suggestedQuality:(YTPlaybackQuality)suggestedQuality
              callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    startSeconds = [self startSecondsForVideoId:videoId startSeconds:startSeconds];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
     NSString *command = [NSString stringWithFormat:@"player.loadVideoById('%@', %@, '%@');", videoId, startSecondsValue, qualityValue];
@@ -390,6 +510,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
            endSeconds:(float)endSeconds
      suggestedQuality:(YTPlaybackQuality)suggestedQuality
              callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    startSeconds = [self startSecondsForVideoId:videoId startSeconds:startSeconds];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSNumber *endSecondsValue = [NSNumber numberWithFloat:endSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
@@ -405,6 +527,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
          startSeconds:(float)startSeconds
      suggestedQuality:(YTPlaybackQuality)suggestedQuality
              callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
     NSString *command = [NSString stringWithFormat:@"player.cueVideoByUrl('%@', %@, '%@');", videoURL, startSecondsValue, qualityValue];
@@ -420,6 +544,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
            endSeconds:(float)endSeconds
      suggestedQuality:(YTPlaybackQuality)suggestedQuality
              callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSNumber *endSecondsValue = [NSNumber numberWithFloat:endSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
@@ -435,6 +561,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
           startSeconds:(float)startSeconds
       suggestedQuality:(YTPlaybackQuality)suggestedQuality
               callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
     NSString *command = [NSString stringWithFormat:@"player.loadVideoByUrl('%@', %@, '%@');", videoURL, startSecondsValue, qualityValue];
@@ -450,6 +578,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
             endSeconds:(float)endSeconds
       suggestedQuality:(YTPlaybackQuality)suggestedQuality
               callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     NSNumber *startSecondsValue = [NSNumber numberWithFloat:startSeconds];
     NSNumber *endSecondsValue = [NSNumber numberWithFloat:endSeconds];
     NSString *qualityValue = NSStringFromYTPlaybackQuality(suggestedQuality);
@@ -464,6 +594,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 #pragma mark - Playing a video in a playlist
 
 - (void)nextVideo:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     [self evaluateJavaScript:@"player.nextVideo();" completionHandler:^(id _Nullable result, NSError * _Nullable error) {
         if (callback) {
             callback(error);
@@ -472,6 +604,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 }
 
 - (void)previouVideo:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     [self evaluateJavaScript:@"player.previousVideo();" completionHandler:^(id _Nullable result, NSError * _Nullable error) {
         if (callback) {
             callback(error);
@@ -480,6 +614,8 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 }
 
 - (void)playVideoAt:(NSInteger)index callback:(nullable YTPlayerViewJSResultVoid)callback {
+    [self detachVideoQueue];
+    [self invalidateCurrentVideoId];
     NSString *command = [NSString stringWithFormat:@"player.playVideoAt(%@);", [NSNumber numberWithInteger:index]];
     [self evaluateJavaScript:command completionHandler:^(id _Nullable result, NSError * _Nullable error) {
         if (callback) {
@@ -651,14 +787,86 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     }];
 }
 
+#pragma mark - Native video queue
+
+- (void)loadVideoQueue:(YTPlayerQueue *)queue
+          startSeconds:(float)startSeconds
+      suggestedQuality:(YTPlaybackQuality)suggestedQuality
+              callback:(nullable YTPlayerViewJSResultVoid)callback {
+    self.videoQueue = queue;
+    self.videoQueueQuality = suggestedQuality;
+    NSString *startSecondsValue = [[NSNumber numberWithFloat:startSeconds] stringValue];
+    [self loadVideoQueueWindowAtPosition:queue.currentPosition function:@"loadPlaylist" startSeconds:startSecondsValue callback:callback];
+}
+
+- (void)cueVideoQueue:(YTPlayerQueue *)queue
+         startSeconds:(float)startSeconds
+     suggestedQuality:(YTPlaybackQuality)suggestedQuality
+             callback:(nullable YTPlayerViewJSResultVoid)callback {
+    self.videoQueue = queue;
+    self.videoQueueQuality = suggestedQuality;
+    NSString *startSecondsValue = [[NSNumber numberWithFloat:startSeconds] stringValue];
+    [self loadVideoQueueWindowAtPosition:queue.currentPosition function:@"cuePlaylist" startSeconds:startSecondsValue callback:callback];
+}
+
+- (void)nextVideoInQueue:(nullable YTPlayerViewJSResultVoid)callback {
+    NSUInteger position = (self.videoQueue != nil) ? [self.videoQueue nextPosition] : NSNotFound;
+    [self playVideoInQueueAtPosition:position callback:callback];
+}
+
+- (void)previousVideoInQueue:(nullable YTPlayerViewJSResultVoid)callback {
+    NSUInteger position = (self.videoQueue != nil) ? [self.videoQueue previousPosition] : NSNotFound;
+    [self playVideoInQueueAtPosition:position callback:callback];
+}
+
+- (void)playVideoInQueueAtPosition:(NSUInteger)position callback:(nullable YTPlayerViewJSResultVoid)callback {
+    YTPlayerQueue *queue = self.videoQueue;
+    if (queue == nil || position >= queue.count) {
+        if (callback) {
+            callback([NSError errorWithDomain:YTPlayerErrorDomain code:YTPlayerErrorInvalidParam userInfo:@{NSLocalizedDescriptionKey: @"There is no video at the given position in the video queue."}]);
+        }
+        return;
+    }
+    if ([queue window:self.videoQueueWindow needsSlidingForPosition:position]) {
+        [self loadVideoQueueWindowAtPosition:position function:@"loadPlaylist" startSeconds:@"0" callback:callback];
+    } else {
+        // The video is already in the iframe player, just jump to it.
+        queue.currentPosition = position;
+        [self playVideoInQueueWindowAtIndex:[queue indexForPosition:position inWindow:self.videoQueueWindow] callback:callback];
+    }
+}
+
+- (void)videoQueuePosition:(nullable YTPlayerViewJSResultInteger)callback {
+    __weak typeof(self) weakSelf = self;
+    [self evaluateJavaScript:@"player.getPlaylistIndex();" completionHandler:^(id _Nullable result, NSError * _Nullable error) {
+        YTPlayerQueue *queue = weakSelf.videoQueue;
+        NSUInteger position = NSNotFound;
+        if (error == nil && queue != nil) {
+            position = [queue positionForIndex:[result integerValue] inWindow:weakSelf.videoQueueWindow];
+        }
+        if (position != NSNotFound) {
+            queue.currentPosition = position;
+        } else if (error == nil) {
+            error = [NSError errorWithDomain:YTPlayerErrorDomain code:YTPlayerErrorUnknown userInfo:@{NSLocalizedDescriptionKey: @"The current video is not in the video queue."}];
+        }
+        if (callback) {
+            callback((position != NSNotFound) ? (NSInteger)position : -1, error);
+        }
+    }];
+}
+
 #pragma mark - Exposed for Testing
 
 - (void)removeWebView {
     self.htmlLoadingNavigation = nil;
     self.webView.navigationDelegate = nil;
     self.webView.UIDelegate = nil;
+    [self.webView.configuration.userContentController removeScriptMessageHandlerForName:YTPlayerScriptMessageLog];
+    [self.webView.configuration.userContentController removeScriptMessageHandlerForName:YTPlayerScriptMessageCallback];
     [self.webView removeFromSuperview];
     self.webView = nil;
+    [self detachVideoQueue];
+    self.qualityStallCheckGeneration++;
 }
 
 #pragma mark - WKNavigationDelegate
@@ -780,14 +988,14 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
 #pragma mark - WKScriptMessageHandler
 
 - (void)userContentController:(WKUserContentController *)userContentController didReceiveScriptMessage:(WKScriptMessage *)message {
-    if ([message.name isEqualToString:@"log"]) {
+    if ([message.name isEqualToString:YTPlayerScriptMessageLog]) {
         // Debugging log JS interface
         // The following JS code in HTML causes this callback, logging the given object with NSLog:
         // `window.webkit.messageHandlers.log.postMessage("Hello, YTPlayerView");`
         // This could be handly to track down things in the HTML.
         // We might want to remove this logging feature in shipping code, but as long as you don't explicitly call `window.webkit.messageHandlers.log` this is harmless at all.
         NSLog(@"[YTPlayerView script log] %@", message.body);
-    } else if ([message.name isEqualToString:@"callback"]) {
+    } else if ([message.name isEqualToString:YTPlayerScriptMessageCallback]) {
         // Callback JS interface
         // This is much more reliable to receive events from JS than using `window.location.href` hack used in UIWebView.
         // We can directly pass objects, but for now we just keep using the old implementation, which is URL string.
@@ -818,8 +1026,9 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     
     // User Script configurations.
     WKUserContentController *userContentController = [[WKUserContentController alloc] init];
-    [userContentController addScriptMessageHandler:self name:@"log"];
-    [userContentController addScriptMessageHandler:self name:@"callback"];
+    YTPlayerWeakScriptMessageHandler *scriptMessageHandler = [[YTPlayerWeakScriptMessageHandler alloc] initWithHandler:self];
+    [userContentController addScriptMessageHandler:scriptMessageHandler name:YTPlayerScriptMessageLog];
+    [userContentController addScriptMessageHandler:scriptMessageHandler name:YTPlayerScriptMessageCallback];
     configuration.userContentController = userContentController;
     
     // Media configurations.
@@ -933,12 +1142,30 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
         }
         
         self.playerState = state;
+        if (state == YTPlayerStateUnstarted || state == YTPlayerStateQueued) {
+            // Another video is being loaded, possibly by the iframe player moving through a playlist by itself.
+            [self invalidateCurrentVideoId];
+        } else if (state == YTPlayerStatePlaying && self.currentVideoId == nil) {
+            [self confirmCurrentVideoId];
+        }
+        if (state == YTPlayerStatePaused) {
+            [self saveResumePosition:YES];
+        } else if (state == YTPlayerStateEnded && self.currentVideoId != nil) {
+            [self.resumeStore removePositionForVideoId:self.currentVideoId];
+        }
+        if (state == YTPlayerStatePlaying && self.videoQueue != nil) {
+            [self synchronizeVideoQueue];
+        }
+        if (self.qualityController != nil) {
+            [self adaptPlaybackQualityToState:state];
+        }
         if ([self.delegate respondsToSelector:@selector(playerView:didChangeToState:)]) {
             [self.delegate playerView:self didChangeToState:state];
         }
     } else if ([action isEqualToString:YTPlayerCallbackOnPlaybackQualityChange]) {
+        YTPlaybackQuality quality = YTPlaybackQualityFromNSString(data);
+        [self.qualityController playerDidChangeToQuality:quality atTime:[NSProcessInfo processInfo].systemUptime];
         if ([self.delegate respondsToSelector:@selector(playerView:didChangeToQuality:)]) {
-            YTPlaybackQuality quality = YTPlaybackQualityFromNSString(data);
             [self.delegate playerView:self didChangeToQuality:quality];
         }
     } else if ([action isEqualToString:YTPlayerCallbackOnError]) {
@@ -960,8 +1187,12 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
             [self delegateErrorWithCode:errorCode description:nil underlyingError:nil];
         }
     } else if ([action isEqualToString:YTPlayerCallbackOnPlayTime]) {
-        // XXX: Might be better to cache the currentTime value internally like playerState
-        if ([self.delegate respondsToSelector:@selector(playerView:didPlayTime:)]) {
+        self.lastPlayTime = [data floatValue];
+        [self saveResumePosition:NO];
+        [self sampleBufferedSecondsIfNeeded];
+        // While scrubbing the player reports wherever the last coalesced seek landed, which jumps around.
+        // The scrubbing position has already been reported in -scrubToSeconds: instead.
+        if (!self.scrubber.isScrubbing && [self.delegate respondsToSelector:@selector(playerView:didPlayTime:)]) {
             float time = [data floatValue];
             [self.delegate playerView:self didPlayTime:time];
         }
@@ -975,6 +1206,283 @@ NSString *NSStringFromYTPlayerJSBoolean(BOOL boolValue) {
     }
 }
 
+- (void)loadVideoQueueWindowAtPosition:(NSUInteger)position
+                              function:(NSString *)function
+                          startSeconds:(NSString *)startSecondsExpression
+                              callback:(nullable YTPlayerViewJSResultVoid)callback {
+    /**
+     * Private method to pass the window of `videoQueue` around the given position to the iframe player.
+     *
+     * @param position A position in the play order of `videoQueue`.
+     * @param function Either "loadPlaylist" or "cuePlaylist".
+     * @param startSecondsExpression A JavaScript expression evaluated as startSeconds of the video at the position.
+     */
+    YTPlayerQueue *queue = self.videoQueue;
+    if (queue == nil || position >= queue.count) {
+        if (callback) {
+            callback([NSError errorWithDomain:YTPlayerErrorDomain code:YTPlayerErrorInvalidParam userInfo:@{NSLocalizedDescriptionKey: @"The video queue is empty."}]);
+        }
+        return;
+    }
+    
+    NSRange window = [queue windowAroundPosition:position];
+    NSError *jsonError = nil;
+    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:[queue videoIdsInWindow:window]
+                                                       options:0
+                                                         error:&jsonError];
+    if (jsonError) {
+        if (callback) {
+            callback([NSError errorWithDomain:YTPlayerErrorDomain code:YTPlayerErrorInvalidParam userInfo:@{NSUnderlyingErrorKey: jsonError}]);
+        }
+        return;
+    }
+    
+    // The iframe player loops the window by itself only when the window is the entire loop.
+    BOOL loop = (queue.loopMode == YTPlayerQueueLoopModeOne) || (queue.loopMode == YTPlayerQueueLoopModeAll && window.length == queue.count);
+    NSString *playlistValue = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+    NSNumber *indexValue = [NSNumber numberWithUnsignedInteger:[queue indexForPosition:position inWindow:window]];
+    NSString *qualityValue = NSStringFromYTPlaybackQuality(self.videoQueueQuality);
+    NSString *command = [NSString stringWithFormat:@"player.%@(%@, %@, %@, '%@'); player.setLoop(%@);", function, playlistValue, indexValue, startSecondsExpression, qualityValue, NSStringFromYTPlayerJSBoolean(loop)];
+    
+    queue.currentPosition = position;
+    [self invalidateCurrentVideoId];
+    self.videoQueueWindow = window;
+    [self evaluateJavaScript:command completionHandler:^(id _Nullable result, NSError * _Nullable error) {
+        if (callback) {
+            callback(error);
+        }
+    }];
+}
+
++ (NSArray<NSString *> *)observedVideoQueueKeyPaths {
+    return @[@"loopMode", @"shuffled", @"shuffleSeed"];
+}
+
+- (void)setVideoQueue:(nullable YTPlayerQueue *)videoQueue {
+    if (_videoQueue == videoQueue) {
+        return;
+    }
+    for (NSString *keyPath in [[self class] observedVideoQueueKeyPaths]) {
+        [_videoQueue removeObserver:self forKeyPath:keyPath context:YTPlayerViewVideoQueueObservationContext];
+    }
+    _videoQueue = videoQueue;
+    for (NSString *keyPath in [[self class] observedVideoQueueKeyPaths]) {
+        [_videoQueue addObserver:self forKeyPath:keyPath options:0 context:YTPlayerViewVideoQueueObservationContext];
+    }
+}
+
+- (void)observeValueForKeyPath:(nullable NSString *)keyPath ofObject:(nullable id)object change:(nullable NSDictionary<NSKeyValueChangeKey, id> *)change context:(nullable void *)context {
+    if (context != YTPlayerViewVideoQueueObservationContext) {
+        [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+        return;
+    }
+    // The loaded window is laid out in the old play order, so stop mapping the iframe player's index through it.
+    self.videoQueueWindow = NSMakeRange(0, 0);
+    // A shuffle changes several properties and moves `currentPosition` last, so reload once it is done.
+    if (self.videoQueueReloadScheduled) {
+        return;
+    }
+    self.videoQueueReloadScheduled = YES;
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        weakSelf.videoQueueReloadScheduled = NO;
+        [weakSelf reloadVideoQueue];
+    });
+}
+
+- (void)reloadVideoQueue {
+    // Replaces the window in the iframe player with the one around the current video in the new play order,
+    // keeping the current video where it is.
+    YTPlayerQueue *queue = self.videoQueue;
+    if (queue == nil || queue.count == 0) {
+        return;
+    }
+    BOOL playing = (self.playerState == YTPlayerStatePlaying || self.playerState == YTPlayerStateBuffering);
+    [self loadVideoQueueWindowAtPosition:queue.currentPosition
+                                function:(playing ? @"loadPlaylist" : @"cuePlaylist")
+                            startSeconds:@"player.getCurrentTime()"
+                                callback:nil];
+}
+
+- (void)detachVideoQueue {
+    // Something other than `videoQueue` is being played. Stop following the queue, or its window would be
+    // synchronized with and reloaded over whatever is playing now.
+    self.videoQueue = nil;
+    self.videoQueueWindow = NSMakeRange(0, 0);
+}
+
+- (void)playVideoInQueueWindowAtIndex:(NSUInteger)index callback:(nullable YTPlayerViewJSResultVoid)callback {
+    // Same as -playVideoAt:callback: but keeps `videoQueue` attached.
+    [self invalidateCurrentVideoId];
+    NSString *command = [NSString stringWithFormat:@"player.playVideoAt(%@);", [NSNumber numberWithUnsignedInteger:index]];
+    [self evaluateJavaScript:command completionHandler:^(id _Nullable result, NSError * _Nullable error) {
+        if (callback) {
+            callback(error);
+        }
+    }];
+}
+
+- (void)synchronizeVideoQueue {
+    // The iframe player moves through the window by itself, so catch up with it and slide the window
+    // before it runs out of videos. Doing this right when a video starts playing costs almost nothing.
+    __weak typeof(self) weakSelf = self;
+    [self videoQueuePosition:^(NSInteger position, NSError * _Nullable error) {
+        YTPlayerQueue *queue = weakSelf.videoQueue;
+        if (error != nil || queue == nil) {
+            return;
+        }
+        if ([queue window:weakSelf.videoQueueWindow needsSlidingForPosition:(NSUInteger)position]) {
+            [weakSelf loadVideoQueueWindowAtPosition:(NSUInteger)position function:@"loadPlaylist" startSeconds:@"player.getCurrentTime()" callback:nil];
+        }
+    }];
+}
+
+- (void)setCurrentVideoId:(nullable NSString *)currentVideoId {
+    if (![_currentVideoId isEqualToString:currentVideoId]) {
+        // Don't save the time of the previous video as the position of the new one.
+        self.lastPlayTime = -1;
+    }
+    _currentVideoId = [currentVideoId copy];
+}
+
+- (void)invalidateCurrentVideoId {
+    /**
+     * Private method to forget the current video when the player switches to another one.
+     * Resume positions are not saved until -confirmCurrentVideoId has asked the player which video it is,
+     * so that the play time of one video is never saved under the ID of another.
+     */
+    self.currentVideoIdGeneration++;
+    self.currentVideoId = nil;
+}
+
+- (void)confirmCurrentVideoId {
+    if (self.resumeStore == nil) {
+        return;
+    }
+    NSUInteger generation = self.currentVideoIdGeneration;
+    __weak typeof(self) weakSelf = self;
+    [self videoURL:^(NSURL * _Nullable videoURL, NSError * _Nullable error) {
+        // Drop the answer if the player has switched videos again in the meantime.
+        if (error != nil || videoURL == nil || weakSelf.currentVideoIdGeneration != generation) {
+            return;
+        }
+        NSURLComponents *components = [NSURLComponents componentsWithURL:videoURL resolvingAgainstBaseURL:NO];
+        for (NSURLQueryItem *queryItem in components.queryItems) {
+            if ([queryItem.name isEqualToString:@"v"] && queryItem.value.length > 0) {
+                weakSelf.currentVideoId = queryItem.value;
+                return;
+            }
+        }
+    }];
+}
+
+- (float)startSecondsForVideoId:(NSString *)videoId startSeconds:(float)startSeconds {
+    /**
+     * Private method to forget the current video and resolve the start time of the one being loaded using `resumeStore`.
+     *
+     * @param videoId The video ID being loaded or cued.
+     * @param startSeconds The start time given by the caller. 0 means to resume.
+     * @return The start time to use.
+     */
+    [self invalidateCurrentVideoId];
+    if (startSeconds > 0 || self.resumeStore == nil) {
+        return startSeconds;
+    }
+    return [self.resumeStore positionForVideoId:videoId];
+}
+
+- (void)saveResumePosition:(BOOL)force {
+    if (self.resumeStore == nil || self.currentVideoId == nil || self.lastPlayTime < 0) {
+        return;
+    }
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    if (!force && now - self.lastResumePositionSaveTime < self.resumePositionSaveInterval) {
+        return;
+    }
+    [self.resumeStore setPosition:self.lastPlayTime forVideoId:self.currentVideoId];
+    self.lastResumePositionSaveTime = now;
+}
+
+- (void)adaptPlaybackQualityToState:(YTPlayerState)state {
+    // Any state change cancels the stall check scheduled for the previous one.
+    self.qualityStallCheckGeneration++;
+    if (state == YTPlayerStateUnstarted || state == YTPlayerStateQueued) {
+        // Another video is being loaded.
+        [self.qualityController reset];
+    } else if (state == YTPlayerStatePlaying) {
+        __weak typeof(self) weakSelf = self;
+        if (self.qualityController.availableQualities == nil) {
+            [self availableQualityLevels:^(NSArray<NSNumber *> * _Nullable values, NSError * _Nullable error) {
+                NSPredicate *knownQuality = [NSPredicate predicateWithFormat:@"integerValue <= %@", @(YTPlaybackQualityHighRes)];
+                NSArray<NSNumber *> *qualities = [values filteredArrayUsingPredicate:knownQuality];
+                if (error == nil && qualities.count > 0) {
+                    weakSelf.qualityController.availableQualities = qualities;
+                }
+            }];
+        }
+        if (self.qualityController.currentQuality > YTPlaybackQualityHighRes) {
+            // The player doesn't necessarily report a quality change when playback starts, and the controller
+            // can't step from an unknown quality.
+            [self playbackQuality:^(NSInteger quality, NSError * _Nullable error) {
+                YTPlayerQualityController *controller = weakSelf.qualityController;
+                if (error == nil && controller.currentQuality > YTPlaybackQualityHighRes) {
+                    [controller playerDidChangeToQuality:(YTPlaybackQuality)quality atTime:[NSProcessInfo processInfo].systemUptime];
+                }
+            }];
+        }
+    } else if (state == YTPlayerStateBuffering) {
+        [self scheduleQualityStallCheck];
+    }
+    [self applyPlaybackQualityDecision:[self.qualityController playerDidChangeToState:state atTime:[NSProcessInfo processInfo].systemUptime]];
+}
+
+- (void)scheduleQualityStallCheck {
+    // The player doesn't report anything while stalled, so keep re-evaluating until the stall ends.
+    // A single check isn't enough: the controller declines within minimumSwitchInterval of the last switch,
+    // and after a step down it times the ongoing stall again from the switch.
+    NSUInteger generation = self.qualityStallCheckGeneration;
+    __weak typeof(self) weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(YTPlayerQualityStallCheckInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        typeof(self) strongSelf = weakSelf;
+        if (strongSelf == nil || strongSelf.qualityController == nil ||
+            strongSelf.qualityStallCheckGeneration != generation || strongSelf.playerState != YTPlayerStateBuffering) {
+            return;
+        }
+        [strongSelf applyPlaybackQualityDecision:[strongSelf.qualityController evaluateAtTime:[NSProcessInfo processInfo].systemUptime]];
+        [strongSelf scheduleQualityStallCheck];
+    });
+}
+
+- (void)sampleBufferedSecondsIfNeeded {
+    // Sampling the loaded part of the video takes a JS evaluation, so do it every few play time callbacks only.
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    if (self.qualityController == nil || now - self.lastBufferSampleTime < 2.0) {
+        return;
+    }
+    self.lastBufferSampleTime = now;
+    float playTime = self.lastPlayTime;
+    __weak typeof(self) weakSelf = self;
+    [self evaluateJavaScript:@"player.getVideoLoadedFraction() * player.getDuration();" completionHandler:^(id _Nullable result, NSError * _Nullable error) {
+        if (error != nil || ![result isKindOfClass:[NSNumber class]]) {
+            return;
+        }
+        YTPlayerQualityDecision *decision = [weakSelf.qualityController playerDidBufferSeconds:[result doubleValue]
+                                                                                       playTime:playTime
+                                                                                         atTime:[NSProcessInfo processInfo].systemUptime];
+        [weakSelf applyPlaybackQualityDecision:decision];
+    }];
+}
+
+- (void)applyPlaybackQualityDecision:(nullable YTPlayerQualityDecision *)decision {
+    if (decision == nil) {
+        return;
+    }
+    [self setPlaybackQuality:decision.toQuality callback:nil];
+    if ([self.delegate respondsToSelector:@selector(playerView:didAdaptPlaybackQuality:)]) {
+        [self.delegate playerView:self didAdaptPlaybackQuality:decision];
+    }
+}
+
 - (void)evaluateJavaScript:(NSString *)javaScriptString completionHandler:(void (^)(_Nullable id result, NSError * _Nullable error))completionHandler {
     if (self.webView == nil) {
         NSError *error = [NSError errorWithDomain:YTPlayerErrorDomain code:YTPlayerErrorJSError userInfo:@{NSLocalizedDescriptionKey: @"YTPlayerView didn't load the internal web view yet. Load before using any other public methods."}];